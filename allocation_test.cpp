@@ -0,0 +1,182 @@
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include "board.h"
+#include "board_quads.h"
+#include "defines.h"
+#include "digit_glyphs.h"
+#include "frame_profiler.h"
+#include "grid_layout.h"
+#include "mine_placement.h"
+#include "mine_probability.h"
+#include "minimap_image.h"
+#include "settings.h"
+
+using namespace ::minis;
+
+static std::atomic<long> allocations{0};
+
+void *operator new(std::size_t size)
+{
+    allocations++;
+    if (void *memory = std::malloc(size ? size : 1))
+        return memory;
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void *memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void *memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void *memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+/**
+ * @brief Stands in for the rlgl batch of `BoardRenderer` and the digit atlas of `DigitalDisplay`,
+ * it only counts what they would draw.
+ *
+ */
+struct CountingSink
+{
+    int quads = 0;
+    int glyphs = 0;
+    int checksum = 0;
+
+    void Tint(QuadColor color) { checksum += color.r + color.a; }
+    void Quad(float x, float y, float, float, Sprite sprite)
+    {
+        quads++;
+        checksum += sprite + (int)x + (int)y;
+    }
+    void Glyph(int glyph, float x, float)
+    {
+        glyphs++;
+        checksum += glyph + (int)x;
+    }
+};
+
+/**
+ * @brief The per frame work behind `Game::Update` and `Game::Draw` which does not need a window:
+ * hit-testing the mouse, the quads of `BoardRenderer::Draw` and `BoardRenderer::DrawHeatmap` (the
+ * body of `Field::Draw`), the glyphs of the timer and the mine counter (`DigitalDisplay::Draw` in
+ * `Game::DrawHeader`), the minimap update and the profiler overlay. The emitting functions are the
+ * ones the game calls, only the sink differs.
+ *
+ */
+static int Frame(const Board &board, const MineProbability &probability, const GridLayout &layout, MinimapImage &minimap,
+                 FrameProfiler &profiler, CountingSink &sink, int frame)
+{
+    int checksum = 0;
+    int row, col;
+    profiler.BeginFrame();
+
+    {
+        ProfileScope scope(profiler, PROFILE_UPDATE);
+        if (layout.CellAt(frame % 500, frame % 300, &row, &col))
+            checksum += row + col;
+    }
+
+    {
+        ProfileScope scope(profiler, PROFILE_FIELD_DRAW);
+        GridRange visible = layout.VisibleRange(0.0f, HEADER_HEIGHT, layout.Width(), HEADER_HEIGHT + layout.Height());
+        EmitBoardQuads(board, layout, visible, sink);
+        EmitHeatmapQuads(board, probability, layout, visible, sink);
+
+        if (minimap.Update(board))
+        {
+            checksum += minimap.DirtyEndRow() - minimap.DirtyFirstRow();
+            minimap.ClearDirty();
+        }
+    }
+
+    {
+        ProfileScope scope(profiler, PROFILE_HEADER_DRAW);
+        EmitDigits(frame / 60, 4, 0.0f, 0.0f, DISPLAY_FONT_SIZE, sink);
+        EmitDigits(board.MineCount() - board.FlagCount(), 1, 0.0f, 0.0f, DISPLAY_FONT_SIZE, sink);
+    }
+
+    FrameStats stats = profiler.Stats();
+    return checksum + (stats.max_ms > 0.0f);
+}
+
+/**
+ * @brief Fails if the per frame work allocates once the game is running.
+ *
+ */
+int main()
+{
+    FrameProfiler profiler;
+    long checksum = 0;
+    int frames = 0;
+    long total = 0;
+    int wrong_counts = 0;
+
+    for (int level = 0; level < DIFFICULTY_LEVEL_COUNT; level++)
+    {
+        GameSettings settings = GetSettings((DifficultyLevel)level);
+        Board board(settings.rows, settings.columns, settings.mines, level, SafeZone(settings.rows, settings.columns, 0, 0));
+        board.Reveal(0, 0);
+        // More flags than mines, so the mine counter goes negative
+        for (int cell = settings.rows * settings.columns - 1; cell >= 0 && board.FlagCount() <= board.MineCount(); cell--)
+            board.ToggleFlag(cell / settings.columns, cell % settings.columns);
+        GridLayout layout = GridLayout{0.0f, HEADER_HEIGHT, (float)settings.tile_size, settings.rows, settings.columns};
+        MinimapImage minimap(board);
+        // The probabilities are only updated after a move, not per frame
+        MineProbability probability(board);
+        probability.Update();
+        CountingSink sink;
+
+        // Warm up, e. g. the first frames fill the profiler history
+        for (int i = 0; i < FRAME_PROFILER_HISTORY; i++)
+            checksum += Frame(board, probability, layout, minimap, profiler, sink, i);
+
+        long before = allocations;
+        for (int i = 0; i < 1000; i++, frames++)
+            checksum += Frame(board, probability, layout, minimap, profiler, sink, i);
+        long allocated = allocations - before;
+        total += allocated;
+
+        if (allocated > 0)
+            printf("%d x %d: %ld allocations in 1000 frames\n", settings.rows, settings.columns, allocated);
+        // Every visible cell, the two border lines and the heatmap of the concealed cells
+        if (sink.quads < (FRAME_PROFILER_HISTORY + 1000) * (settings.rows * settings.columns + 2) || sink.glyphs == 0)
+        {
+            printf("%d x %d: %d quads and %d glyphs emitted\n", settings.rows, settings.columns, sink.quads, sink.glyphs);
+            wrong_counts++;
+        }
+        checksum += sink.checksum;
+    }
+
+    // Every kept frame lands in one bucket of the histogram
+    FrameStats stats = profiler.Stats();
+    int bucketed = 0;
+    for (int count : stats.histogram)
+        bucketed += count;
+    if (bucketed != profiler.SampleCount())
+    {
+        printf("the histogram holds %d of %d frames\n", bucketed, profiler.SampleCount());
+        wrong_counts++;
+    }
+
+    printf("%d frames, %ld allocations (checksum %ld)\n", frames, total, checksum);
+    return total > 0 || wrong_counts > 0 ? 1 : 0;
+}
@@ -0,0 +1,161 @@
+#include "asset_cache.h"
+#include "board_renderer.h"
+#include "defines.h"
+#include <algorithm>
+#include <string>
+
+namespace minis
+{
+    namespace
+    {
+        /**
+         * @brief Returns a color code based on a number (amount of adjacent mines i. e.).
+         *
+         * @param number A number (amount of adjacent mines i. e.).
+         * @return Color Color code based on the number passed.
+         */
+        Color NumberColor(int number)
+        {
+            switch (number)
+            {
+            case 1:
+                return BLUE;
+            case 2:
+                return GREEN;
+            case 3:
+                return RED;
+            default:
+                return DARKBLUE;
+            }
+        }
+    }
+
+    AssetCache::AssetCache()
+    {
+        click_sound = LoadSound("assets/click.wav");
+        file_loads++;
+
+        for (int level = 0; level < DIFFICULTY_LEVEL_COUNT; level++)
+        {
+            GameSettings settings = GetSettings((DifficultyLevel)level);
+            TileAtlas(settings.tile_size, settings.font_size);
+        }
+        DigitAtlas(DISPLAY_FONT_SIZE);
+    }
+
+    AssetCache::~AssetCache()
+    {
+        for (auto &atlas : atlases)
+            UnloadTexture(atlas.second);
+        for (auto &atlas : digit_atlases)
+            UnloadTexture(atlas.second.texture);
+        StopSound(click_sound);
+        UnloadSound(click_sound);
+    }
+
+    Texture2D AssetCache::TileAtlas(int tile_size, int font_size)
+    {
+        auto key = std::make_pair(tile_size, font_size);
+        auto atlas = atlases.find(key);
+        if (atlas != atlases.end())
+            return atlas->second;
+
+        Texture2D texture = BuildTileAtlas(tile_size, font_size);
+        atlases.emplace(key, texture);
+        return texture;
+    }
+
+    GlyphAtlas AssetCache::DigitAtlas(int font_size)
+    {
+        auto atlas = digit_atlases.find(font_size);
+        if (atlas != digit_atlases.end())
+            return atlas->second;
+
+        GlyphAtlas glyphs = BuildDigitAtlas(font_size);
+        digit_atlases.emplace(font_size, glyphs);
+        return glyphs;
+    }
+
+    /**
+     * @brief Renders the digits and the minus sign with the default font into equally wide cells.
+     *
+     * @param font_size Font size of the digits.
+     */
+    GlyphAtlas AssetCache::BuildDigitAtlas(int font_size)
+    {
+        const char *glyph_text[DIGIT_GLYPH_COUNT] = {"0", "1", "2", "3", "4", "5", "6", "7", "8", "9", "-"};
+        int glyph_width = 0;
+        for (const char *text : glyph_text)
+            glyph_width = std::max(glyph_width, MeasureText(text, font_size));
+
+        Image image = GenImageColor(glyph_width * DIGIT_GLYPH_COUNT, font_size, BLANK);
+        for (int glyph = 0; glyph < DIGIT_GLYPH_COUNT; glyph++)
+        {
+            int offset = (glyph_width - MeasureText(glyph_text[glyph], font_size)) / 2;
+            ImageDrawText(&image, glyph_text[glyph], glyph * glyph_width + offset, 0, font_size, WHITE);
+        }
+
+        GlyphAtlas atlas = GlyphAtlas{LoadTextureFromImage(image), glyph_width, font_size};
+        UnloadImage(image);
+        return atlas;
+    }
+
+    /**
+     * @brief Builds the atlas image from the tile assets.
+     *
+     * @param tile_size Pixel size of a tile.
+     * @param font_size Font size of the numbers in the tiles.
+     */
+    Texture2D AssetCache::BuildTileAtlas(int tile_size, int font_size)
+    {
+        std::string suffix = "_" + std::to_string(tile_size) + "x" + std::to_string(tile_size) + ".png";
+        Image tile = LoadImage(("assets/tile" + suffix).c_str());
+        Image flag = LoadImage(("assets/flag" + suffix).c_str());
+        Image mine = LoadImage(("assets/mine" + suffix).c_str());
+        Image cross = LoadImage(("assets/cross" + suffix).c_str());
+        file_loads += 4;
+
+        Image image = GenImageColor(tile_size * SPRITE_COUNT, tile_size, BLANK);
+        Rectangle source = Rectangle{0, 0, (float)tile_size, (float)tile_size};
+        auto slot = [tile_size](int sprite)
+        { return Rectangle{(float)(sprite * tile_size), 0, (float)tile_size, (float)tile_size}; };
+
+        // Open cells show the background with the grid lines on their upper and left border
+        for (int sprite = SPRITE_OPEN; sprite < SPRITE_COUNT; sprite++)
+        {
+            if (sprite == SPRITE_SOLID)
+                continue;
+            Rectangle dest = slot(sprite);
+            ImageDrawRectangle(&image, dest.x, dest.y, tile_size, tile_size, RAYWHITE);
+            ImageDrawRectangle(&image, dest.x, dest.y, tile_size, 1, LIGHTGRAY);
+            ImageDrawRectangle(&image, dest.x, dest.y, 1, tile_size, LIGHTGRAY);
+        }
+
+        ImageDraw(&image, tile, source, slot(SPRITE_CONCEALED), WHITE);
+        ImageDraw(&image, tile, source, slot(SPRITE_FLAG), WHITE);
+        ImageDraw(&image, flag, source, slot(SPRITE_FLAG), WHITE);
+        ImageDraw(&image, mine, source, slot(SPRITE_MINE), WHITE);
+        Rectangle triggered = slot(SPRITE_MINE_TRIGGERED);
+        ImageDrawRectangle(&image, triggered.x, triggered.y, tile_size, tile_size, RED);
+        ImageDraw(&image, mine, source, triggered, WHITE);
+        ImageDraw(&image, mine, source, slot(SPRITE_WRONG_FLAG), WHITE);
+        ImageDraw(&image, cross, source, slot(SPRITE_WRONG_FLAG), WHITE);
+        Rectangle solid = slot(SPRITE_SOLID);
+        ImageDrawRectangle(&image, solid.x, solid.y, tile_size, tile_size, WHITE);
+
+        for (int number = 1; number <= 8; number++)
+        {
+            Rectangle dest = slot(SPRITE_NUMBER_1 + number - 1);
+            ImageDrawText(&image, std::to_string(number).c_str(), dest.x + 10, dest.y + 5, font_size, NumberColor(number));
+        }
+
+        Texture2D atlas = LoadTextureFromImage(image);
+
+        UnloadImage(image);
+        UnloadImage(tile);
+        UnloadImage(flag);
+        UnloadImage(mine);
+        UnloadImage(cross);
+        return atlas;
+    }
+}
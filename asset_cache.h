@@ -0,0 +1,91 @@
+#ifndef ASSET_CACHE_H
+#define ASSET_CACHE_H
+
+#include <map>
+#include <utility>
+#include "raylib.h"
+#include "settings.h"
+#include "digit_glyphs.h"
+
+namespace minis
+{
+    /**
+     * @brief Texture holding the glyphs of `DigitGlyphs` side by side, white on transparent so
+     * they can be drawn in any color.
+     *
+     */
+    struct GlyphAtlas
+    {
+        Texture2D texture;
+        int glyph_width;
+        int glyph_height;
+
+        inline Rectangle Glyph(int glyph) const
+        {
+            return Rectangle{(float)(glyph * glyph_width), 0.0f, (float)glyph_width, (float)glyph_height};
+        }
+    };
+
+    /**
+     * @brief Owns the textures and sounds of the game. Every asset is loaded once, boards share
+     * them by their raylib handle and everything is unloaded when the cache is destroyed.
+     *
+     */
+    class AssetCache
+    {
+    public:
+        /**
+         * @brief Construct a new AssetCache object and load the assets of every difficulty level,
+         * so starting a game never reads from disk. Needs the window and the audio device.
+         *
+         */
+        AssetCache();
+
+        /**
+         * @brief Destroy the AssetCache object and unload all assets. The handles it returned
+         * must not be used afterwards.
+         *
+         */
+        ~AssetCache();
+
+        AssetCache(const AssetCache &) = delete;
+        AssetCache &operator=(const AssetCache &) = delete;
+
+        /**
+         * @brief Returns the tile atlas (see `Sprite`) of a tile and font size, it is built on the
+         * first request.
+         *
+         * @param tile_size Pixel size of a tile, selects the asset set.
+         * @param font_size Font size of the numbers in the tiles.
+         * @return Texture2D Atlas owned by the cache.
+         */
+        Texture2D TileAtlas(int tile_size, int font_size);
+
+        /**
+         * @brief Returns the digit atlas of a font size, it is built on the first request.
+         *
+         * @param font_size Font size of the digits.
+         * @return GlyphAtlas Atlas owned by the cache.
+         */
+        GlyphAtlas DigitAtlas(int font_size);
+
+        inline Sound ClickSound() const { return click_sound; }
+
+        /**
+         * @brief Returns the number of files read so far.
+         *
+         */
+        inline int FileLoads() const { return file_loads; }
+
+    private:
+        std::map<std::pair<int, int>, Texture2D> atlases;
+        std::map<int, GlyphAtlas> digit_atlases;
+        Sound click_sound;
+        int file_loads = 0;
+
+        Texture2D BuildTileAtlas(int tile_size, int font_size);
+        GlyphAtlas BuildDigitAtlas(int font_size);
+    };
+}
+
+#endif
@@ -0,0 +1,823 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <string>
+#include <vector>
+#include "rng.h"
+#include "mine_placement.h"
+#include "neighbor_count.h"
+#include "grid_layout.h"
+#include "board.h"
+#include "solver.h"
+#include "mine_probability.h"
+#include "no_guess.h"
+#include "replay.h"
+#include "snapshot.h"
+#include "minimap_image.h"
+#include "game_server.h"
+#include "settings.h"
+
+using namespace ::minis;
+
+/**
+ * @brief Mine placement as it was done by the Field constructor: draw random cells until a free one
+ * is hit. Kept here as baseline for the comparison.
+ *
+ */
+static void PlaceMinesRejection(uint8_t *plane, int rows, int columns, int mines, Rng &rng)
+{
+    int num_mines_placed = 0;
+
+    while (num_mines_placed < mines)
+    {
+        int row = rng.Range(0, rows - 1);
+        int col = rng.Range(0, columns - 1);
+
+        if (!plane[row * columns + col])
+        {
+            plane[row * columns + col] = 1;
+            num_mines_placed++;
+        }
+    }
+}
+
+/**
+ * @brief Neighbor counting as it was done by the Field constructor: eight bounds checked lookups
+ * through nested vectors per cell. Kept here as baseline for the comparison.
+ *
+ */
+static void CountNeighborMinesPerCell(const std::vector<std::vector<uint8_t>> &grid, std::vector<std::vector<uint8_t>> &counts)
+{
+    int rows = grid.size();
+    int columns = grid.at(0).size();
+    auto mine_in_tile = [&](int row, int col)
+    {
+        if (row < 0 || row > rows - 1 || col < 0 || col > columns - 1)
+            return false;
+        return grid.at(row).at(col) != 0;
+    };
+
+    for (int row = 0; row < rows; row++)
+    {
+        for (int col = 0; col < columns; col++)
+        {
+            int num_mines = 0;
+            for (int d_row = -1; d_row <= 1; d_row++)
+            {
+                for (int d_col = -1; d_col <= 1; d_col++)
+                {
+                    if ((d_row != 0 || d_col != 0) && mine_in_tile(row + d_row, col + d_col))
+                        num_mines++;
+                }
+            }
+            counts.at(row).at(col) = num_mines;
+        }
+    }
+}
+
+/**
+ * @brief One measured value. `benchmark` names the operation, `variant` the implementation (or
+ * statistic) and rows, columns and mines the board it ran on.
+ *
+ */
+struct Result
+{
+    std::string benchmark;
+    std::string variant;
+    int rows;
+    int columns;
+    int mines;
+    int repetitions;
+    double value;
+    const char *unit;
+};
+
+enum class Format
+{
+    Table,
+    Csv,
+    Json,
+};
+
+static std::vector<Result> results;
+// Benchmarks which check their results count the failures, any of them fails the run
+static int failed_checks = 0;
+
+static void Record(const std::string &benchmark, const std::string &variant, int rows, int columns, int mines,
+                   int repetitions, double value, const char *unit = "ms")
+{
+    results.push_back(Result{benchmark, variant, rows, columns, mines, repetitions, value, unit});
+}
+
+/**
+ * @brief Runs `func` `repetitions` times and returns the average run time in milliseconds.
+ *
+ */
+template <typename Func>
+static double Measure(int repetitions, Func func)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repetitions; i++)
+        func(i);
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / repetitions;
+}
+
+/**
+ * @brief Like `Measure`, but only times `func`: `setup(i)` creates the state `func` works on
+ * (e. g. a fresh board for a destructive operation) outside of the measurement.
+ *
+ */
+template <typename Setup, typename Func>
+static double MeasureEach(int repetitions, Setup setup, Func func)
+{
+    double total = 0.0;
+    for (int i = 0; i < repetitions; i++)
+    {
+        auto state = setup(i);
+        auto start = std::chrono::steady_clock::now();
+        func(state);
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        total += elapsed.count();
+    }
+    return total / repetitions;
+}
+
+/**
+ * @brief The operations behind the game: building a board (what the `Field` constructor does),
+ * mine placement, neighbor counting, the first click (`HandleLeftMouse`: safe zone and flood
+ * fill), flood fill alone, hit-testing and flagging (`HandleRightMouse`) and revealing the
+ * whole board at the end of a game (`RevealGrid`).
+ *
+ */
+static void BenchmarkBoardOperations(int rows, int columns, int mines, int repetitions)
+{
+    int cells = rows * columns;
+    int center_row = rows / 2;
+    int center_col = columns / 2;
+    auto new_board = [&](int i)
+    { return Board(rows, columns, mines, i); };
+    auto opened_board = [&](int i)
+    { return Board(rows, columns, mines, i, SafeZone(rows, columns, center_row, center_col)); };
+
+    Record("construct", "board", rows, columns, mines, repetitions,
+           Measure(repetitions, [&](int i)
+                   { Board board(rows, columns, mines, i); }));
+    // One byte per cell plus the three bit planes
+    Record("memory", "cells", rows, columns, mines, 1, (double)sizeof(Cell) * cells / (1 << 20), "MiB");
+    Record("memory", "bit_planes", rows, columns, mines, 1, (double)BitBoard::PLANE_COUNT * ((cells + 63) / 64) * 8 / (1 << 20), "MiB");
+
+    {
+        std::vector<uint8_t> plane(cells);
+        std::vector<uint8_t> counts(cells);
+        std::vector<int> zone = SafeZone(rows, columns, center_row, center_col);
+
+        Record("place_mines", "floyd", rows, columns, mines, repetitions,
+               Measure(repetitions, [&](int i)
+                       {
+                           std::fill(plane.begin(), plane.end(), 0);
+                           Rng rng(i);
+                           PlaceMines(plane.data(), cells, mines, zone, rng); }));
+        Record("neighbor_count", NeighborCountKernel(), rows, columns, mines, repetitions,
+               Measure(repetitions, [&](int)
+                       { CountNeighborMines(plane.data(), rows, columns, counts.data()); }));
+    }
+
+    Record("first_click", "board", rows, columns, mines, repetitions,
+           MeasureEach(repetitions, new_board, [&](Board &board)
+                       {
+                           board.SafeFirstClick(center_row, center_col, 1);
+                           board.Reveal(center_row, center_col); }));
+    Record("flood_fill", "scanline", rows, columns, mines, repetitions,
+           MeasureEach(repetitions, opened_board, [&](Board &board)
+                       { board.FloodFill(center_row, center_col); }));
+    Record("reveal_all", "bit_planes", rows, columns, mines, repetitions,
+           MeasureEach(repetitions, opened_board, [&](Board &board)
+                       { board.RevealAll(); }));
+
+    // Random points across the whole board (and a little outside of it)
+    const int clicks = 10000;
+    const float tile_size = 31.0f;
+    GridLayout layout{0.0f, 50.0f, tile_size, rows, columns};
+    std::vector<float> points(2 * clicks);
+    Rng rng(3);
+    for (int i = 0; i < clicks; i++)
+    {
+        points[2 * i] = rng.Range(-10, (int)layout.Width() + 10);
+        points[2 * i + 1] = rng.Range(40, (int)layout.Height() + 60);
+    }
+
+    volatile int sink = 0;
+    Record("hit_test", "grid_layout", rows, columns, mines, repetitions,
+           Measure(repetitions, [&](int)
+                   {
+                       int row, col, hits = 0;
+                       for (int i = 0; i < clicks; i++)
+                           hits += layout.CellAt(points[2 * i], points[2 * i + 1], &row, &col);
+                       sink = hits; }) * 1e6 / clicks,
+           "ns");
+
+    Board board = opened_board(0);
+    board.Reveal(center_row, center_col);
+    Record("right_click", "board", rows, columns, mines, repetitions,
+           Measure(repetitions, [&](int)
+                   {
+                       int row, col;
+                       for (int i = 0; i < clicks; i++)
+                       {
+                           if (layout.CellAt(points[2 * i], points[2 * i + 1], &row, &col))
+                               board.ToggleFlag(row, col);
+                       } }) * 1e6 / clicks,
+           "ns");
+}
+
+/**
+ * @brief Compares the Floyd mine placement against rejection sampling at three densities.
+ *
+ */
+static void BenchmarkMinePlacement(int rows, int columns, int repetitions)
+{
+    int cells = rows * columns;
+    std::vector<uint8_t> plane(cells);
+
+    for (int density : {10, 50, 95})
+    {
+        int mines = (int)((long long)cells * density / 100);
+
+        Record("place_mines", "rejection", rows, columns, mines, repetitions,
+               Measure(repetitions, [&](int i)
+                       {
+                           std::fill(plane.begin(), plane.end(), 0);
+                           Rng rng(i);
+                           PlaceMinesRejection(plane.data(), rows, columns, mines, rng); }));
+        Record("place_mines", "floyd", rows, columns, mines, repetitions,
+               Measure(repetitions, [&](int i)
+                       {
+                           std::fill(plane.begin(), plane.end(), 0);
+                           Rng rng(i);
+                           PlaceMines(plane.data(), cells, mines, SafeZone(rows, columns, rows / 2, columns / 2), rng); }));
+    }
+}
+
+/**
+ * @brief Compares the neighbor count kernels against the per cell lookups of the old `Field`.
+ *
+ */
+static void BenchmarkNeighborCount(int rows, int columns, int repetitions)
+{
+    int cells = rows * columns;
+    int mines = cells / 5;
+    std::vector<uint8_t> plane(cells, 0);
+    std::vector<uint8_t> counts(cells);
+    Rng rng(1);
+    PlaceMines(plane.data(), cells, mines, {}, rng);
+
+    std::vector<std::vector<uint8_t>> grid(rows, std::vector<uint8_t>(columns));
+    std::vector<std::vector<uint8_t>> grid_counts(rows, std::vector<uint8_t>(columns));
+    for (int i = 0; i < cells; i++)
+        grid[i / columns][i % columns] = plane[i];
+
+    Record("neighbor_count", "per_cell", rows, columns, mines, repetitions,
+           Measure(repetitions, [&](int)
+                   { CountNeighborMinesPerCell(grid, grid_counts); }));
+    Record("neighbor_count", "scalar", rows, columns, mines, repetitions,
+           Measure(repetitions, [&](int)
+                   { CountNeighborMinesScalar(plane.data(), rows, columns, counts.data()); }));
+    Record("neighbor_count", NeighborCountKernel(), rows, columns, mines, repetitions,
+           Measure(repetitions, [&](int)
+                   { CountNeighborMines(plane.data(), rows, columns, counts.data()); }));
+}
+
+/**
+ * @brief Compares whole board queries on the cells against the bit planes.
+ *
+ */
+static void BenchmarkBitBoard(int rows, int columns, int repetitions)
+{
+    int mines = rows * columns / 8;
+    Board board(rows, columns, mines, 1);
+    Rng rng(2);
+    for (int i = 0; i < 2000; i++)
+    {
+        if (i % 4 == 0)
+            board.ToggleFlag(rng.Below(rows), rng.Below(columns));
+        else if (!board.At(i % rows, (i * 7) % columns).mine)
+            board.Reveal(i % rows, (i * 7) % columns);
+    }
+
+    const BitBoard &bits = board.Bits();
+    int cells = rows * columns;
+    volatile int sink = 0;
+
+    Record("flags_on_mines", "cells", rows, columns, mines, repetitions,
+           Measure(repetitions, [&](int)
+                   {
+                       int count = 0;
+                       for (int i = 0; i < cells; i++)
+                       {
+                           const Cell &cell = board.At(i / columns, i % columns);
+                           count += cell.flagged && cell.mine;
+                       }
+                       sink = count; }));
+    Record("flags_on_mines", "bit_planes", rows, columns, mines, repetitions,
+           Measure(repetitions, [&](int)
+                   { sink = bits.CountFlagsOnMines(); }));
+
+    Record("win_check", "cells", rows, columns, mines, repetitions,
+           Measure(repetitions, [&](int)
+                   {
+                       bool won = true;
+                       for (int i = 0; i < cells; i++)
+                       {
+                           const Cell &cell = board.At(i / columns, i % columns);
+                           won = won && (cell.mine || !cell.concealed);
+                       }
+                       sink = won; }));
+    Record("win_check", "bit_planes", rows, columns, mines, repetitions,
+           Measure(repetitions, [&](int)
+                   { sink = bits.AllSafeRevealed(); }));
+
+    Record("frontier", "cells", rows, columns, mines, repetitions,
+           Measure(repetitions, [&](int)
+                   {
+                       int count = 0;
+                       for (int row = 0; row < rows; row++)
+                       {
+                           for (int col = 0; col < columns; col++)
+                           {
+                               if (!board.At(row, col).concealed)
+                                   continue;
+                               bool frontier = false;
+                               for (int d_row = -1; d_row <= 1 && !frontier; d_row++)
+                                   for (int d_col = -1; d_col <= 1 && !frontier; d_col++)
+                                       frontier = board.IsValid(row + d_row, col + d_col) && !board.At(row + d_row, col + d_col).concealed;
+                               count += frontier;
+                           }
+                       }
+                       sink = count; }));
+    Record("frontier", "bit_planes", rows, columns, mines, repetitions,
+           Measure(repetitions, [&](int)
+                   { sink = (int)bits.Frontier().size(); }));
+}
+
+/**
+ * @brief Plays every certain move from a safe first click until the solver is stuck, which is the
+ * workload of the autoplay mode.
+ *
+ */
+static void BenchmarkSolver(int rows, int columns, int mines, int games)
+{
+    long long moves = 0;
+    int won = 0;
+
+    double per_game = Measure(games, [&](int i)
+                              {
+                                  Board board(rows, columns, mines, i, SafeZone(rows, columns, rows / 2, columns / 2));
+                                  board.Reveal(rows / 2, columns / 2);
+                                  Solver solver(board);
+                                  SolverMove move;
+
+                                  while (!board.Won() && solver.NextMove(&move))
+                                  {
+                                      if (move.mine)
+                                      {
+                                          board.ToggleFlag(move.row, move.col);
+                                      }
+                                      else
+                                      {
+                                          board.Reveal(move.row, move.col);
+                                          solver.Observe(board.LastOpened());
+                                      }
+                                      moves++;
+                                  }
+                                  won += board.Won(); });
+
+    Record("solver_autoplay", "game", rows, columns, mines, games, per_game);
+    Record("solver_autoplay", "move", rows, columns, mines, games, moves ? per_game * games * 1000.0 / moves : 0.0, "us");
+    Record("solver_autoplay", "solved", rows, columns, mines, games, won * 100.0 / games, "%");
+}
+
+/**
+ * @brief Plays games by always revealing the safest cell and times every probability update, once
+ * with the component cache of the previous move and once from scratch.
+ *
+ */
+static void BenchmarkMineProbability(int rows, int columns, int mines, int games)
+{
+    double cached = 0.0, fresh = 0.0, worst = 0.0;
+    int updates = 0;
+
+    for (int game = 0; game < games; game++)
+    {
+        Board board(rows, columns, mines, game, SafeZone(rows, columns, rows / 2, columns / 2));
+        board.Reveal(rows / 2, columns / 2);
+        MineProbability probability(board);
+
+        while (!board.Won() && !board.Lost())
+        {
+            double update = Measure(1, [&](int)
+                                    { probability.Update(); });
+            fresh += Measure(1, [&](int)
+                             { MineProbability(board).Update(); });
+            cached += update;
+            worst = std::max(worst, update);
+            updates++;
+
+            int safest = probability.SafestCell();
+            board.Reveal(safest / columns, safest % columns);
+        }
+    }
+
+    Record("mine_probability", "fresh", rows, columns, mines, updates, fresh / updates);
+    Record("mine_probability", "cached", rows, columns, mines, updates, cached / updates);
+    Record("mine_probability", "cached_worst", rows, columns, mines, updates, worst);
+}
+
+/**
+ * @brief Times the generation of boards which can be solved without guessing for every preset.
+ *
+ */
+static void BenchmarkNoGuess(int boards)
+{
+    for (int level = 0; level < DIFFICULTY_LEVEL_COUNT; level++)
+    {
+        GameSettings settings = GetSettings((DifficultyLevel)level);
+        Record("no_guess", "rejection", settings.rows, settings.columns, settings.mines, boards,
+               Measure(boards, [&](int i)
+                       { Board board; GenerateNoGuess(settings.rows, settings.columns, settings.mines, i, &board); }));
+    }
+}
+
+/**
+ * @brief Records games played by the solver (falling back to the safest guess) and times encoding,
+ * decoding and verifying their replays.
+ *
+ */
+static void BenchmarkReplay(int rows, int columns, int mines, int games)
+{
+    std::vector<std::vector<uint8_t>> encoded;
+    size_t bytes = 0;
+
+    for (int game = 0; game < games; game++)
+    {
+        Board board(rows, columns, mines, game, SafeZone(rows, columns, rows / 2, columns / 2));
+        ReplayRecorder recorder(board);
+        Solver solver(board);
+        MineProbability probability(board);
+        SolverMove move;
+        uint32_t frame = 0;
+
+        board.Reveal(rows / 2, columns / 2);
+        recorder.Record(frame, ReplayAction::Reveal, rows / 2, columns / 2);
+        solver.Observe(board.LastOpened());
+
+        while (!board.Won() && !board.Lost())
+        {
+            frame += 10;
+            if (!solver.NextMove(&move))
+            {
+                probability.Update();
+                int safest = probability.SafestCell();
+                move = SolverMove{safest / columns, safest % columns, false};
+            }
+
+            if (move.mine)
+            {
+                board.ToggleFlag(move.row, move.col);
+                recorder.Record(frame, ReplayAction::Flag, move.row, move.col);
+            }
+            else
+            {
+                board.Reveal(move.row, move.col);
+                recorder.Record(frame, ReplayAction::Reveal, move.row, move.col);
+                solver.Observe(board.LastOpened());
+            }
+        }
+
+        encoded.push_back(recorder.Finish().Encode());
+        bytes += encoded.back().size();
+    }
+
+    std::vector<Replay> replays(games);
+    int failed = 0;
+    double decode = Measure(games, [&](int i)
+                            { failed += !Replay::Decode(encoded[i].data(), encoded[i].size(), &replays[i]); });
+    double verify = Measure(games, [&](int i)
+                            { failed += !VerifyReplay(replays[i]); });
+    if (failed)
+        fprintf(stderr, "%d replays failed to decode or verify\n", failed);
+    failed_checks += failed;
+
+    Record("replay", "bytes", rows, columns, mines, games, (double)bytes / games, "B");
+    Record("replay", "decode", rows, columns, mines, games, decode * 1000.0, "us");
+    Record("replay", "verify", rows, columns, mines, games, verify * 1000.0, "us");
+}
+
+/**
+ * @brief Saving a game in progress: the first (full) save, a save after a single flag (only the
+ * changed page and the header are written) and resuming from the file.
+ *
+ */
+static void BenchmarkSnapshot(int rows, int columns, int mines, int repetitions)
+{
+    std::string path = (std::filesystem::temp_directory_path() / "minisweeper_bench.sav").string();
+    GameSettings settings = GameSettings{rows, columns, mines, TILE_SIZE_SMALL, FONT_SIZE_SMALL};
+    Board board(rows, columns, mines, 1, SafeZone(rows, columns, rows / 2, columns / 2));
+    board.Reveal(rows / 2, columns / 2);
+    SnapshotWriter writer(path);
+    int full_pages = 0, incremental_pages = 0, failed = 0;
+
+    double full = MeasureEach(repetitions, [&](int)
+                              { writer.Discard(); return 0; },
+                              [&](int)
+                              { failed += !writer.Save(board, settings, 0);
+                                full_pages = writer.PagesWritten(); });
+    double incremental = Measure(repetitions, [&](int i)
+                                 { board.ToggleFlag(i % rows, 0);
+                                   failed += !writer.Save(board, settings, 0);
+                                   incremental_pages = writer.PagesWritten(); });
+    double load = Measure(repetitions, [&](int)
+                          { Board loaded;
+                            uint64_t elapsed_ms;
+                            failed += !LoadSnapshot(path, &loaded, &settings, &elapsed_ms); });
+    writer.Discard();
+    if (failed)
+        fprintf(stderr, "%d snapshot saves or loads failed\n", failed);
+    failed_checks += failed;
+
+    Record("snapshot_save", "full", rows, columns, mines, repetitions, full);
+    Record("snapshot_save", "full_pages", rows, columns, mines, repetitions, full_pages, "pages");
+    Record("snapshot_save", "dirty", rows, columns, mines, repetitions, incremental);
+    Record("snapshot_save", "dirty_pages", rows, columns, mines, repetitions, incremental_pages, "pages");
+    Record("snapshot_load", "mmap", rows, columns, mines, repetitions, load);
+}
+
+/**
+ * @brief The minimap: a full rebuild against the update after a flag and after the first click on
+ * a sparse board, which only recolors the opened cells and leaves one band of dirty rows, i. e.
+ * one partial texture upload.
+ *
+ */
+static void BenchmarkMinimap(int rows, int columns, int mines, int repetitions)
+{
+    Board board(rows, columns, mines, 1);
+    MinimapImage image(board);
+    double rebuild = Measure(repetitions, [&](int)
+                             { image.Rebuild(board); });
+    double flag = Measure(repetitions, [&](int i)
+                          { board.ToggleFlag(i % rows, i % columns);
+                            image.Update(board);
+                            image.ClearDirty(); });
+
+    double update = 0.0;
+    int opened = 0, dirty_rows = 0;
+    for (int i = 0; i < repetitions; i++)
+    {
+        Board clicked(rows, columns, mines, i + 1, SafeZone(rows, columns, rows / 2, columns / 2));
+        MinimapImage clicked_image(clicked);
+        clicked_image.ClearDirty();
+        clicked.Reveal(rows / 2, columns / 2);
+        opened = (int)clicked.LastOpened().size();
+        update += Measure(1, [&](int)
+                          { clicked_image.Update(clicked); });
+        dirty_rows = clicked_image.DirtyEndRow() - clicked_image.DirtyFirstRow();
+    }
+
+    Record("minimap", "rebuild", rows, columns, mines, repetitions, rebuild);
+    Record("minimap", "flag", rows, columns, mines, repetitions, flag);
+    Record("minimap", "update", rows, columns, mines, repetitions, update / repetitions);
+    Record("minimap", "opened", rows, columns, mines, repetitions, opened, "cells");
+    Record("minimap", "dirty_rows", rows, columns, mines, repetitions, dirty_rows, "rows");
+}
+
+/**
+ * @brief Bot of `BenchmarkServer`: plays random reveals on Expert boards in a closed loop, the
+ * next request goes out from the worker which delivered the response.
+ *
+ */
+class ServerBot : public ServerConnection
+{
+public:
+    ServerBot(GameServer &server, int moves, uint64_t seed, std::function<void()> done)
+        : server(server), moves_left(moves), rng(seed), done(std::move(done))
+    {
+        latencies_us.reserve(moves + moves / 4);
+    }
+
+    void Start(const std::shared_ptr<ServerBot> &self)
+    {
+        this->self = self;
+        Request(WriteNewGame(message, next_request++, 16, 30, 99, rng.Next() | 1));
+    }
+
+    void Send(const uint8_t *data, size_t size) override
+    {
+        latencies_us.push_back(std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - sent).count());
+        ResponseHeader header;
+        ReadResponseHeader(data, size, &header);
+        const uint8_t *payload = data + SERVER_RESPONSE_HEADER_SIZE;
+
+        bool over = false;
+        if (header.type == ServerMessage::NewGame)
+            game_id = (uint32_t)GetLittleEndian(payload, 4);
+        else if (header.type == ServerMessage::Reveal)
+            over = payload[1] != (uint8_t)ServerGameState::Playing;
+
+        if (moves_left == 0)
+        {
+            self.reset();
+            done();
+        }
+        else if (over)
+            Request(WriteNewGame(message, next_request++, 16, 30, 99, rng.Next() | 1));
+        else
+        {
+            moves_left--;
+            Request(WriteMove(message, ServerMessage::Reveal, next_request++, game_id, (int)rng.Below(16), (int)rng.Below(30)));
+        }
+    }
+
+    std::vector<float> latencies_us;
+
+private:
+    GameServer &server;
+    std::shared_ptr<ServerBot> self;
+    int moves_left;
+    Rng rng;
+    std::function<void()> done;
+    uint8_t message[SERVER_MAX_REQUEST_SIZE];
+    uint32_t next_request = 1;
+    uint32_t game_id = 0;
+    std::chrono::steady_clock::time_point sent;
+
+    void Request(size_t size)
+    {
+        sent = std::chrono::steady_clock::now();
+        server.Submit(message, size, self);
+    }
+};
+
+/**
+ * @brief The game server in process, without the socket: many bots play at once, each waits for
+ * its response before the next move. Reports the requests per second per worker thread and the
+ * latency from submitting a request to its response. With more bots than threads the server is
+ * saturated and the latency is mostly the wait behind the other bots' requests.
+ *
+ */
+static void BenchmarkServer(int bots, int moves_per_bot, int threads)
+{
+    std::vector<std::shared_ptr<ServerBot>> all_bots;
+    std::mutex mutex;
+    std::condition_variable finished;
+    int running = bots;
+    long steals = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    {
+        GameServer server(threads);
+        for (int i = 0; i < bots; i++)
+        {
+            all_bots.push_back(std::make_shared<ServerBot>(server, moves_per_bot, i + 1, [&]()
+                                                           { std::lock_guard<std::mutex> lock(mutex);
+                                                             if (--running == 0)
+                                                                 finished.notify_one(); }));
+        }
+        for (auto &bot : all_bots)
+            bot->Start(bot);
+
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [&]()
+                      { return running == 0; });
+        steals = server.Stats().steals;
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::vector<float> latencies;
+    for (auto &bot : all_bots)
+        latencies.insert(latencies.end(), bot->latencies_us.begin(), bot->latencies_us.end());
+    std::sort(latencies.begin(), latencies.end());
+    double requests_per_second = latencies.size() / elapsed.count();
+
+    Record("server", "requests_per_s", bots, threads, 99, moves_per_bot, requests_per_second, "1/s");
+    Record("server", "per_thread", bots, threads, 99, moves_per_bot, requests_per_second / threads, "1/s");
+    Record("server", "p50", bots, threads, 99, moves_per_bot, latencies[latencies.size() / 2], "us");
+    Record("server", "p99", bots, threads, 99, moves_per_bot, latencies[latencies.size() * 99 / 100], "us");
+    Record("server", "steals", bots, threads, 99, moves_per_bot, steals, "tasks");
+}
+
+static void PrintTable()
+{
+    printf("%-18s %-14s %6s %6s %9s %6s %14s\n", "benchmark", "variant", "rows", "cols", "mines", "reps", "value");
+    for (const Result &result : results)
+    {
+        printf("%-18s %-14s %6d %6d %9d %6d %14.4f %s\n", result.benchmark.c_str(), result.variant.c_str(),
+               result.rows, result.columns, result.mines, result.repetitions, result.value, result.unit);
+    }
+}
+
+static void PrintCsv()
+{
+    printf("benchmark,variant,rows,columns,mines,repetitions,value,unit\n");
+    for (const Result &result : results)
+    {
+        printf("%s,%s,%d,%d,%d,%d,%.6f,%s\n", result.benchmark.c_str(), result.variant.c_str(),
+               result.rows, result.columns, result.mines, result.repetitions, result.value, result.unit);
+    }
+}
+
+static void PrintJson(bool smoke)
+{
+    printf("{\n  \"kernel\": \"%s\",\n  \"smoke\": %s,\n  \"results\": [\n", NeighborCountKernel(), smoke ? "true" : "false");
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const Result &result = results[i];
+        printf("    {\"benchmark\": \"%s\", \"variant\": \"%s\", \"rows\": %d, \"columns\": %d, \"mines\": %d, "
+               "\"repetitions\": %d, \"value\": %.6f, \"unit\": \"%s\"}%s\n",
+               result.benchmark.c_str(), result.variant.c_str(), result.rows, result.columns, result.mines,
+               result.repetitions, result.value, result.unit, i + 1 < results.size() ? "," : "");
+    }
+    printf("  ]\n}\n");
+}
+
+int main(int argc, char **argv)
+{
+    bool smoke = false;
+    Format format = Format::Table;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--smoke") == 0)
+            smoke = true;
+        else if (strcmp(argv[i], "--csv") == 0)
+            format = Format::Csv;
+        else if (strcmp(argv[i], "--json") == 0)
+            format = Format::Json;
+        else
+        {
+            fprintf(stderr, "Usage: %s [--smoke] [--csv | --json]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    // The smoke run only checks that everything runs, it keeps to the presets and small sizes
+    int repetitions = smoke ? 1 : 5;
+    for (int level = 0; level < DIFFICULTY_LEVEL_COUNT; level++)
+    {
+        GameSettings settings = GetSettings((DifficultyLevel)level);
+        BenchmarkBoardOperations(settings.rows, settings.columns, settings.mines, smoke ? 1 : 100);
+    }
+
+    if (smoke)
+    {
+        BenchmarkMinePlacement(100, 100, repetitions);
+        BenchmarkNeighborCount(100, 100, repetitions);
+        BenchmarkBitBoard(200, 200, repetitions);
+        BenchmarkSolver(16, 30, 99, 5);
+        BenchmarkMineProbability(16, 30, 99, 2);
+        BenchmarkNoGuess(2);
+        BenchmarkReplay(16, 30, 99, 5);
+        BenchmarkSnapshot(16, 30, 99, repetitions);
+        BenchmarkMinimap(100, 100, 100, repetitions);
+        BenchmarkServer(8, 100, 2);
+    }
+    else
+    {
+        // Custom sizes at Expert density
+        BenchmarkBoardOperations(1000, 1000, 1000 * 1000 * 99 / 480, repetitions);
+        BenchmarkBoardOperations(10000, 10000, (int)(10000LL * 10000 * 99 / 480), 1);
+
+        BenchmarkMinePlacement(1000, 1000, repetitions);
+        BenchmarkNeighborCount(1000, 1000, repetitions);
+        BenchmarkBitBoard(2000, 2000, repetitions);
+        BenchmarkSolver(16, 30, 99, 200);
+        BenchmarkSolver(1000, 1000, 150000, 3);
+        BenchmarkMineProbability(16, 30, 99, 50);
+        BenchmarkNoGuess(50);
+        BenchmarkReplay(16, 30, 99, 1000);
+        BenchmarkSnapshot(16, 30, 99, 100);
+        // The largest game there is to resume, see `CUSTOM_MAX_SIZE`
+        BenchmarkSnapshot(1000, 1000, 1000 * 1000 * 99 / 480, repetitions);
+        // Sparse, so the first click opens well over 100k cells
+        BenchmarkMinimap(1000, 1000, 1000 * 1000 / 12, repetitions);
+        // Rows are the bots and columns the worker threads
+        int threads = (int)std::max(1u, std::thread::hardware_concurrency());
+        BenchmarkServer(1, 100000, 1);
+        BenchmarkServer(threads, 100000, threads);
+        BenchmarkServer(10000, 100, threads);
+    }
+
+    if (format == Format::Csv)
+        PrintCsv();
+    else if (format == Format::Json)
+        PrintJson(smoke);
+    else
+        PrintTable();
+
+    return failed_checks > 0 ? 1 : 0;
+}
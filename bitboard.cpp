@@ -0,0 +1,142 @@
+#include "bitboard.h"
+
+namespace minis
+{
+    namespace
+    {
+        // out = in shifted towards higher cell indices by `count` bits
+        void ShiftUp(const std::vector<uint64_t> &in, std::vector<uint64_t> &out, size_t count)
+        {
+            size_t word_shift = count / 64;
+            unsigned bit_shift = count % 64;
+
+            for (size_t w = out.size(); w-- > 0;)
+            {
+                uint64_t value = 0;
+                if (w >= word_shift)
+                {
+                    value = in[w - word_shift] << bit_shift;
+                    if (bit_shift && w > word_shift)
+                        value |= in[w - word_shift - 1] >> (64 - bit_shift);
+                }
+                out[w] = value;
+            }
+        }
+
+        // out = in shifted towards lower cell indices by `count` bits
+        void ShiftDown(const std::vector<uint64_t> &in, std::vector<uint64_t> &out, size_t count)
+        {
+            size_t word_shift = count / 64;
+            unsigned bit_shift = count % 64;
+            size_t size = in.size();
+
+            for (size_t w = 0; w < size; w++)
+            {
+                uint64_t value = 0;
+                if (w + word_shift < size)
+                {
+                    value = in[w + word_shift] >> bit_shift;
+                    if (bit_shift && w + word_shift + 1 < size)
+                        value |= in[w + word_shift + 1] << (64 - bit_shift);
+                }
+                out[w] = value;
+            }
+        }
+    }
+
+    BitBoard::BitBoard(int rows, int columns)
+        : rows(rows), columns(columns), words(((size_t)rows * columns + 63) / 64)
+    {
+        size_t cells = (size_t)rows * columns;
+        last_word_mask = cells % 64 ? (1ULL << (cells % 64)) - 1 : ~0ULL;
+
+        for (auto &plane : planes)
+            plane.assign(words, 0);
+
+        // Column masks keep horizontal shifts from wrapping into the adjacent row
+        first_column.assign(words, 0);
+        last_column.assign(words, 0);
+        for (int row = 0; row < rows; row++)
+        {
+            size_t first = (size_t)row * columns;
+            size_t last = first + columns - 1;
+            first_column[first >> 6] |= 1ULL << (first & 63);
+            last_column[last >> 6] |= 1ULL << (last & 63);
+        }
+    }
+
+    void BitBoard::Assign(Plane plane, const uint8_t *bytes)
+    {
+        size_t cells = (size_t)rows * columns;
+
+        for (size_t w = 0; w < words; w++)
+        {
+            uint64_t value = 0;
+            size_t end = w * 64 + 64 < cells ? 64 : cells - w * 64;
+            for (size_t bit = 0; bit < end; bit++)
+                value |= (uint64_t)(bytes[w * 64 + bit] != 0) << bit;
+            planes[plane][w] = value;
+        }
+    }
+
+    int BitBoard::Count(Plane plane) const
+    {
+        int count = 0;
+        for (uint64_t word : planes[plane])
+            count += __builtin_popcountll(word);
+        return count;
+    }
+
+    int BitBoard::CountFlagsOnMines() const
+    {
+        int count = 0;
+        for (size_t w = 0; w < words; w++)
+            count += __builtin_popcountll(planes[FLAG][w] & planes[MINE][w]);
+        return count;
+    }
+
+    bool BitBoard::AllSafeRevealed() const
+    {
+        for (size_t w = 0; w < words; w++)
+        {
+            uint64_t valid = w == words - 1 ? last_word_mask : ~0ULL;
+            if (~(planes[MINE][w] | planes[REVEALED][w]) & valid)
+                return false;
+        }
+        return true;
+    }
+
+    std::vector<uint64_t> BitBoard::Frontier() const
+    {
+        if (words == 0)
+            return std::vector<uint64_t>();
+
+        const std::vector<uint64_t> &revealed = planes[REVEALED];
+        std::vector<uint64_t> shifted(words);
+        std::vector<uint64_t> horizontal(revealed);
+
+        // Dilate horizontally: a cell is hit if its left or right neighbor is revealed
+        ShiftUp(revealed, shifted, 1);
+        for (size_t w = 0; w < words; w++)
+            horizontal[w] |= shifted[w] & ~first_column[w];
+        ShiftDown(revealed, shifted, 1);
+        for (size_t w = 0; w < words; w++)
+            horizontal[w] |= shifted[w] & ~last_column[w];
+        horizontal[words - 1] &= last_word_mask;
+
+        // Dilate vertically by one row in both directions, which also covers the diagonals
+        std::vector<uint64_t> frontier(horizontal);
+        ShiftUp(horizontal, shifted, columns);
+        for (size_t w = 0; w < words; w++)
+            frontier[w] |= shifted[w];
+        ShiftDown(horizontal, shifted, columns);
+        for (size_t w = 0; w < words; w++)
+            frontier[w] |= shifted[w];
+
+        for (size_t w = 0; w < words; w++)
+            frontier[w] &= ~revealed[w];
+        frontier[words - 1] &= last_word_mask;
+
+        return frontier;
+    }
+}
@@ -0,0 +1,122 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace minis
+{
+    /**
+     * @brief Bit planes of a board, one bit per cell (row-major) and one `uint64_t` per 64 cells.
+     * Whole board queries are popcounts and word-wide AND/OR operations.
+     *
+     */
+    class BitBoard
+    {
+    public:
+        enum Plane
+        {
+            MINE = 0,
+            REVEALED,
+            FLAG,
+            PLANE_COUNT,
+        };
+
+        BitBoard() : rows(0), columns(0), words(0), last_word_mask(0) {}
+
+        /**
+         * @brief Construct a new BitBoard object with all planes cleared.
+         *
+         * @param rows Number of rows.
+         * @param columns Number of columns.
+         */
+        BitBoard(int rows, int columns);
+
+        inline bool Test(Plane plane, int index) const { return (planes[plane][index >> 6] >> (index & 63)) & 1; }
+        inline void Set(Plane plane, int index) { planes[plane][index >> 6] |= 1ULL << (index & 63); }
+        inline void Clear(Plane plane, int index) { planes[plane][index >> 6] &= ~(1ULL << (index & 63)); }
+        inline void Flip(Plane plane, int index) { planes[plane][index >> 6] ^= 1ULL << (index & 63); }
+        inline const std::vector<uint64_t> &Words(Plane plane) const { return planes[plane]; }
+
+        /**
+         * @brief Overwrites a plane from a byte plane (one byte per cell, non zero means set).
+         *
+         * @param plane Target plane.
+         * @param bytes One byte per cell.
+         */
+        void Assign(Plane plane, const uint8_t *bytes);
+
+        /**
+         * @brief Overwrites a plane with words as returned by `Words()`.
+         *
+         * @param plane Target plane.
+         * @param words One bit per cell, the size has to match.
+         */
+        inline void AssignWords(Plane plane, const std::vector<uint64_t> &words) { planes[plane] = words; }
+
+        /**
+         * @brief Clears every bit of a plane, keeping its storage.
+         *
+         */
+        inline void ClearPlane(Plane plane) { std::fill(planes[plane].begin(), planes[plane].end(), 0); }
+
+        /**
+         * @brief Returns the number of set bits in a plane.
+         *
+         */
+        int Count(Plane plane) const;
+
+        /**
+         * @brief Returns the number of flags placed on mines.
+         *
+         */
+        int CountFlagsOnMines() const;
+
+        /**
+         * @brief Checks if every cell without a mine is revealed.
+         *
+         */
+        bool AllSafeRevealed() const;
+
+        /**
+         * @brief Reveals all concealed mines and flagged cells with word-wide ORs.
+         *
+         * @param on_reveal Called with the index of every cell that got revealed.
+         */
+        template <typename Func>
+        void RevealMinesAndFlags(Func on_reveal)
+        {
+            for (size_t w = 0; w < words; w++)
+            {
+                uint64_t hidden = (planes[MINE][w] | planes[FLAG][w]) & ~planes[REVEALED][w];
+                planes[REVEALED][w] |= hidden;
+
+                while (hidden)
+                {
+                    on_reveal((int)(w * 64 + __builtin_ctzll(hidden)));
+                    hidden &= hidden - 1;
+                }
+            }
+        }
+
+        /**
+         * @brief Computes the frontier: concealed cells with at least one revealed neighbor.
+         *
+         * @return std::vector<uint64_t> Bit plane of the frontier cells.
+         */
+        std::vector<uint64_t> Frontier() const;
+
+    private:
+        int rows;
+        int columns;
+        size_t words;
+        uint64_t last_word_mask;
+        std::vector<uint64_t> planes[PLANE_COUNT];
+        std::vector<uint64_t> first_column;
+        std::vector<uint64_t> last_column;
+    };
+}
+
+#endif
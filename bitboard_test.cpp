@@ -0,0 +1,156 @@
+#include <cstdio>
+#include <vector>
+#include "bitboard.h"
+#include "board.h"
+#include "mine_placement.h"
+#include "rng.h"
+
+using namespace ::minis;
+
+#define MAX_TEST_SIZE 70
+
+static int failed = 0;
+
+static void Check(bool condition, const char *what, int rows, int columns)
+{
+    if (condition)
+        return;
+    printf("FAILED (%d x %d): %s\n", rows, columns, what);
+    failed++;
+}
+
+/**
+ * @brief Returns true if a concealed cell has a revealed neighbor, the reference for `Frontier`.
+ *
+ */
+static bool OnFrontier(const std::vector<uint8_t> &revealed, int rows, int columns, int row, int col)
+{
+    if (revealed[row * columns + col])
+        return false;
+    for (int r = row - 1; r <= row + 1; r++)
+    {
+        for (int c = col - 1; c <= col + 1; c++)
+        {
+            if (r >= 0 && r < rows && c >= 0 && c < columns && revealed[r * columns + c])
+                return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Fills the planes at random and compares every whole board operation with a cell by
+ * cell loop over the same bytes.
+ *
+ */
+static void CheckRandomPlanes(Rng &rng, int rows, int columns)
+{
+    int cells = rows * columns;
+    std::vector<uint8_t> planes[BitBoard::PLANE_COUNT];
+    BitBoard bits(rows, columns);
+    // Sparse reveals give a ragged frontier, dense ones leave single concealed cells
+    int density[BitBoard::PLANE_COUNT] = {(int)rng.Below(101), (int)rng.Below(101), (int)rng.Below(101)};
+    for (int plane = 0; plane < BitBoard::PLANE_COUNT; plane++)
+    {
+        planes[plane].resize(cells);
+        for (uint8_t &bit : planes[plane])
+            bit = (int)rng.Below(100) < density[plane];
+        bits.Assign((BitBoard::Plane)plane, planes[plane].data());
+    }
+    const std::vector<uint8_t> &mine = planes[BitBoard::MINE];
+    const std::vector<uint8_t> &revealed = planes[BitBoard::REVEALED];
+    const std::vector<uint8_t> &flag = planes[BitBoard::FLAG];
+
+    int flags_on_mines = 0;
+    bool all_safe_revealed = true;
+    int counts[BitBoard::PLANE_COUNT] = {};
+    for (int i = 0; i < cells; i++)
+    {
+        flags_on_mines += flag[i] && mine[i];
+        all_safe_revealed = all_safe_revealed && (mine[i] || revealed[i]);
+        for (int plane = 0; plane < BitBoard::PLANE_COUNT; plane++)
+            counts[plane] += planes[plane][i];
+    }
+    for (int plane = 0; plane < BitBoard::PLANE_COUNT; plane++)
+        Check(bits.Count((BitBoard::Plane)plane) == counts[plane], "Count matches the cells", rows, columns);
+    Check(bits.CountFlagsOnMines() == flags_on_mines, "CountFlagsOnMines matches the cells", rows, columns);
+    Check(bits.AllSafeRevealed() == all_safe_revealed, "AllSafeRevealed matches the cells", rows, columns);
+
+    std::vector<uint64_t> frontier = bits.Frontier();
+    bool frontier_matches = frontier.size() == bits.Words(BitBoard::REVEALED).size();
+    for (int i = 0; i < cells && frontier_matches; i++)
+        frontier_matches = (((frontier[i >> 6] >> (i & 63)) & 1) != 0) == OnFrontier(revealed, rows, columns, i / columns, i % columns);
+    // No bits past the last cell
+    if (frontier_matches && cells % 64)
+        frontier_matches = (frontier.back() >> (cells % 64)) == 0;
+    Check(frontier_matches, "Frontier matches the cells", rows, columns);
+
+    std::vector<uint8_t> reported(cells, 0);
+    bits.RevealMinesAndFlags([&](int index)
+                             { reported[index] = 1; });
+    bool reveal_matches = true;
+    for (int i = 0; i < cells; i++)
+    {
+        bool hidden = (mine[i] || flag[i]) && !revealed[i];
+        reveal_matches = reveal_matches && reported[i] == hidden && bits.Test(BitBoard::REVEALED, i) == (revealed[i] || hidden);
+    }
+    Check(reveal_matches, "RevealMinesAndFlags reveals the concealed mines and flags", rows, columns);
+}
+
+/**
+ * @brief Plays random games and checks that the counters of `Board` agree with its bit planes
+ * after every move: the win check, the flags and the opened cells.
+ *
+ */
+static void CheckBoardBookkeeping(Rng &rng, int rows, int columns)
+{
+    int mines = 1 + (int)rng.Below(rows * columns / 4 + 1);
+    if (mines > rows * columns - 9)
+        return;
+
+    int row = (int)rng.Below(rows), col = (int)rng.Below(columns);
+    Board board(rows, columns, mines, rng.Next(), SafeZone(rows, columns, row, col));
+    bool consistent = true;
+    for (int move = 0; move < 4 * rows * columns && !board.Lost() && !board.Won(); move++)
+    {
+        // Mostly reveals of free cells, so many games end with a win
+        if (rng.Below(4) == 0)
+            board.ToggleFlag(row, col);
+        else if (!board.At(row, col).mine || rng.Below(16) == 0)
+            board.Reveal(row, col);
+
+        const BitBoard &bits = board.Bits();
+        int flags_on_mines = 0;
+        for (int i = 0; i < rows * columns; i++)
+            flags_on_mines += board.At(i / columns, i % columns).flagged && board.At(i / columns, i % columns).mine;
+        consistent = consistent && board.Won() == (!board.Lost() && bits.AllSafeRevealed()) &&
+                     board.FlagCount() == bits.Count(BitBoard::FLAG) && bits.CountFlagsOnMines() == flags_on_mines;
+
+        row = (int)rng.Below(rows);
+        col = (int)rng.Below(columns);
+    }
+    Check(consistent, "the counters of Board agree with its bit planes", rows, columns);
+}
+
+/**
+ * @brief Checks the whole board operations of `BitBoard` against cell by cell loops on every
+ * width from 1 to `MAX_TEST_SIZE`, i. e. rows ending anywhere within a word, and the
+ * bookkeeping of `Board` against them.
+ *
+ */
+int main()
+{
+    Rng rng(1);
+    for (int columns = 1; columns <= MAX_TEST_SIZE; columns++)
+    {
+        for (int board = 0; board < 4; board++)
+        {
+            int rows = 1 + (int)rng.Below(MAX_TEST_SIZE);
+            CheckRandomPlanes(rng, rows, columns);
+            CheckBoardBookkeeping(rng, rows, columns);
+        }
+    }
+
+    printf("%d checks failed\n", failed);
+    return failed > 0 ? 1 : 0;
+}
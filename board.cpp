@@ -0,0 +1,308 @@
+#include "board.h"
+#include "rng.h"
+#include "mine_placement.h"
+#include "neighbor_count.h"
+
+namespace minis
+{
+    /**
+     * @brief Create a board object and populate it with mines.
+     *
+     * @param rows Number of rows.
+     * @param columns Number of columns.
+     * @param mines Number of mines to place.
+     * @param seed Seed for the mine placement.
+     * @param excluded Flat indices of cells which must not contain a mine.
+     */
+    Board::Board(int rows, int columns, int mines, uint64_t seed, const std::vector<int> &excluded)
+        : rows(rows), columns(columns), mines(mines)
+    {
+        if (columns < 1 || rows < 1)
+            throw("Unable to create a board with less than 1 column or row.");
+
+        cells.resize((size_t)rows * columns);
+        bits = BitBoard(rows, columns);
+        // The span stack only holds disjoint zero runs, it rarely outgrows a couple of rows/columns.
+        fill_stack.reserve(2 * (rows + columns));
+        Generate(seed, excluded);
+    }
+
+    Board::Board(const GameSettings &settings, uint64_t seed)
+        : Board(settings.rows, settings.columns, settings.mines, seed) {}
+
+    Board::Board(int rows, int columns, const std::vector<uint64_t> &mine_words, uint64_t seed)
+        : rows(rows), columns(columns), mines(0), seed(seed)
+    {
+        if (columns < 1 || rows < 1)
+            throw("Unable to create a board with less than 1 column or row.");
+        if (mine_words.size() != ((size_t)rows * columns + 63) / 64)
+            throw("Unable to create a board from a layout of a different size.");
+
+        cells.resize((size_t)rows * columns);
+        bits = BitBoard(rows, columns);
+        fill_stack.reserve(2 * (rows + columns));
+
+        std::vector<uint8_t> plane(cells.size());
+        for (size_t i = 0; i < cells.size(); i++)
+            plane[i] = (mine_words[i >> 6] >> (i & 63)) & 1;
+        for (uint8_t mine : plane)
+            mines += mine;
+        SetMines(plane.data());
+    }
+
+    void Board::Generate(uint64_t seed, const std::vector<int> &excluded)
+    {
+        Rng rng(seed);
+        std::vector<uint8_t> plane(cells.size(), 0);
+        PlaceMines(plane.data(), (int)cells.size(), mines, excluded, rng);
+        this->seed = seed;
+        SetMines(plane.data());
+    }
+
+    /**
+     * @brief Takes over a mine layout and calculates the neighbor counts.
+     *
+     * @param plane One byte per cell, non zero for a mine.
+     */
+    void Board::SetMines(const uint8_t *plane)
+    {
+        std::vector<uint8_t> counts(cells.size());
+        CountNeighborMines(plane, rows, columns, counts.data());
+        bits.Assign(BitBoard::MINE, plane);
+
+        for (size_t i = 0; i < cells.size(); i++)
+        {
+            cells[i].mine = plane[i];
+            cells[i].neighbor_mines = counts[i];
+        }
+    }
+
+    void Board::SafeFirstClick(int row, int col, uint64_t seed)
+    {
+        if (open_count > 0 || lost || !IsValid(row, col))
+            return;
+
+        std::vector<int> zone = SafeZone(rows, columns, row, col);
+        int free_cells = rows * columns - mines;
+
+        if (free_cells < 1)
+            return;
+        if (free_cells < (int)zone.size())
+            zone = {row * columns + col};
+
+        Generate(seed, zone);
+    }
+
+    RevealResult Board::Reveal(int row, int col)
+    {
+        last_opened.clear();
+        if (lost || Won() || !IsValid(row, col))
+            return RevealResult::Ignored;
+
+        Cell &cell = CellAt(row, col);
+        if (!cell.concealed || cell.flagged)
+            return RevealResult::Ignored;
+
+        if (cell.mine)
+        {
+            cell.concealed = false;
+            bits.Set(BitBoard::REVEALED, row * columns + col);
+            last_opened.push_back(row * columns + col);
+            cell.triggered = true;
+            lost = true;
+            RevealAll();
+            return RevealResult::Exploded;
+        }
+
+        FloodFill(row, col);
+
+        if (Won())
+            RevealAll();
+
+        return RevealResult::Opened;
+    }
+
+    bool Board::ToggleFlag(int row, int col)
+    {
+        if (!IsValid(row, col))
+            return false;
+
+        Cell &cell = CellAt(row, col);
+        if (!cell.concealed)
+            return false;
+
+        cell.flagged = !cell.flagged;
+        bits.Flip(BitBoard::FLAG, row * columns + col);
+        flag_count += cell.flagged ? 1 : -1;
+        return true;
+    }
+
+    BoardState Board::SaveState() const
+    {
+        BoardState state;
+        state.revealed = bits.Words(BitBoard::REVEALED);
+        state.flags = bits.Words(BitBoard::FLAG);
+        state.open_count = open_count;
+
+        for (size_t i = 0; i < cells.size() && lost; i++)
+        {
+            if (cells[i].triggered)
+                state.triggered = (int)i;
+        }
+
+        return state;
+    }
+
+    void Board::RestoreState(const BoardState &state)
+    {
+        bits.AssignWords(BitBoard::REVEALED, state.revealed);
+        bits.AssignWords(BitBoard::FLAG, state.flags);
+
+        for (size_t i = 0; i < cells.size(); i++)
+        {
+            cells[i].concealed = !bits.Test(BitBoard::REVEALED, (int)i);
+            cells[i].flagged = bits.Test(BitBoard::FLAG, (int)i);
+            cells[i].triggered = (int)i == state.triggered;
+        }
+
+        open_count = state.open_count;
+        flag_count = bits.Count(BitBoard::FLAG);
+        lost = state.triggered >= 0;
+        last_opened.clear();
+    }
+
+    void Board::Reset(uint64_t seed, const std::vector<int> &excluded)
+    {
+        for (Cell &cell : cells)
+        {
+            cell.concealed = true;
+            cell.flagged = false;
+            cell.triggered = false;
+        }
+        bits.ClearPlane(BitBoard::REVEALED);
+        bits.ClearPlane(BitBoard::FLAG);
+        open_count = 0;
+        flag_count = 0;
+        lost = false;
+        last_opened.clear();
+        Generate(seed, excluded);
+    }
+
+    void Board::RevealAll()
+    {
+        bits.RevealMinesAndFlags([this](int index)
+                                 { cells[index].concealed = false; });
+    }
+
+    /**
+     * @brief Opens a concealed cell and records it in `last_opened`.
+     *
+     * @param index Flat index of the cell.
+     */
+    void Board::Open(int index)
+    {
+        cells[index].concealed = false;
+        bits.Set(BitBoard::REVEALED, index);
+        open_count++;
+        last_opened.push_back(index);
+    }
+
+    /**
+     * @brief Opens the maximal run of fillable cells on `row` containing `col` and pushes it onto
+     * the flood fill stack.
+     *
+     * @param row Row index of the run.
+     * @param col Column index of a fillable cell inside the run.
+     */
+    void Board::PushSpan(int row, int col)
+    {
+        Cell *line = &cells[row * columns];
+        int left = col;
+        int right = col;
+
+        while (left > 0 && Fillable(line[left - 1]))
+            left--;
+        while (right < columns - 1 && Fillable(line[right + 1]))
+            right++;
+
+        for (int c = left; c <= right; c++)
+            Open(row * columns + c);
+
+        fill_stack.push_back(Span{row, left, right});
+    }
+
+    /**
+     * @brief Performs the flood fill algorithm on a certain cell in the grid. Zero cells are opened
+     * as horizontal runs (scanline), every run is pushed once onto an explicit stack which then
+     * opens the bordering number cells and seeds the runs on the rows above and below.
+     * Runs in time linear to the opened area and without recursion.
+     *
+     * @param row Row index of the cell.
+     * @param col Column index of the cell.
+     * @return int Number of cells opened.
+     */
+    int Board::FloodFill(int row, int col)
+    {
+        if (!IsValid(row, col))
+            return 0;
+
+        Cell &cell = CellAt(row, col);
+        if (cell.flagged || cell.mine || !cell.concealed)
+            return 0;
+
+        size_t opened_before = last_opened.size();
+
+        if (cell.neighbor_mines > 0)
+        {
+            Open(row * columns + col);
+            return 1;
+        }
+
+        fill_stack.clear();
+        PushSpan(row, col);
+
+        while (!fill_stack.empty())
+        {
+            Span span = fill_stack.back();
+            fill_stack.pop_back();
+
+            int left = span.left > 0 ? span.left - 1 : 0;
+            int right = span.right < columns - 1 ? span.right + 1 : columns - 1;
+
+            // Number cells left and right of the run
+            for (int c : {left, right})
+            {
+                int index = span.row * columns + c;
+                if (cells[index].concealed && !cells[index].flagged)
+                    Open(index);
+            }
+
+            // Rows above and below, including the diagonals
+            for (int r : {span.row - 1, span.row + 1})
+            {
+                if (r < 0 || r >= rows)
+                    continue;
+
+                for (int c = left; c <= right; c++)
+                {
+                    int index = r * columns + c;
+                    const Cell &neighbor = cells[index];
+                    if (!neighbor.concealed || neighbor.flagged)
+                        continue;
+
+                    if (neighbor.neighbor_mines == 0)
+                    {
+                        PushSpan(r, c);
+                        c = fill_stack.back().right;
+                    }
+                    else
+                    {
+                        Open(index);
+                    }
+                }
+            }
+        }
+
+        return (int)(last_opened.size() - opened_before);
+    }
+}
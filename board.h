@@ -0,0 +1,275 @@
+#ifndef BOARD_H
+#define BOARD_H
+
+#include <vector>
+#include <cstdint>
+#include "settings.h"
+#include "bitboard.h"
+
+namespace minis
+{
+    /**
+     * @brief Gameplay state of a single cell on the board, packed into one byte so the cells of
+     * a board are a flat array of one byte each and a cell with all its neighbors spans at most
+     * three cache lines. Screen positions are not stored, they follow from the `GridLayout`.
+     *
+     */
+    struct Cell
+    {
+        bool mine : 1;
+        bool concealed : 1;
+        bool flagged : 1;
+        bool triggered : 1;
+        uint8_t neighbor_mines : 4;
+
+        Cell() : mine(false), concealed(true), flagged(false), triggered(false), neighbor_mines(0) {}
+        Cell(bool mine, bool concealed, bool flagged, bool triggered, int neighbor_mines)
+            : mine(mine), concealed(concealed), flagged(flagged), triggered(triggered), neighbor_mines(neighbor_mines) {}
+    };
+    static_assert(sizeof(Cell) == 1, "A cell has to fit into one byte");
+
+    /**
+     * @brief Everything that changes on a board while playing (its layout aside), i. e. to save and
+     * restore positions.
+     *
+     */
+    struct BoardState
+    {
+        std::vector<uint64_t> revealed;
+        std::vector<uint64_t> flags;
+        int open_count = 0;
+        int triggered = -1;
+
+        inline bool operator==(const BoardState &other) const
+        {
+            return revealed == other.revealed && flags == other.flags &&
+                   open_count == other.open_count && triggered == other.triggered;
+        }
+    };
+
+    /**
+     * @brief Outcome of a reveal request on the board.
+     *
+     */
+    enum class RevealResult
+    {
+        Ignored,
+        Opened,
+        Exploded,
+    };
+
+    /**
+     * @brief Headless minesweeper board holding the game rules (mine placement, neighbor counts,
+     * reveal, flag and win/loss). It has no dependency on raylib, `Field` renders on top of it.
+     *
+     */
+    class Board
+    {
+    public:
+        Board() : rows(0), columns(0), mines(0) {}
+
+        /**
+         * @brief Construct a new Board object and populate it with mines.
+         *
+         * @param rows Number of rows.
+         * @param columns Number of columns.
+         * @param mines Number of mines to place.
+         * @param seed Seed for the mine placement, equal seeds create equal boards.
+         * @param excluded Flat indices of cells which must not contain a mine.
+         */
+        Board(int rows, int columns, int mines, uint64_t seed, const std::vector<int> &excluded = {});
+
+        /**
+         * @brief Construct a new Board object from game settings.
+         *
+         * @param settings Game settings (rows, columns and mines are used).
+         * @param seed Seed for the mine placement, equal seeds create equal boards.
+         */
+        Board(const GameSettings &settings, uint64_t seed);
+
+        /**
+         * @brief Construct a new Board object from a given mine layout.
+         *
+         * @param rows Number of rows.
+         * @param columns Number of columns.
+         * @param mine_words Mine plane, one bit per cell as returned by `Bits().Words(BitBoard::MINE)`.
+         * @param seed Seed the layout was generated from, only kept for `Seed()`.
+         */
+        Board(int rows, int columns, const std::vector<uint64_t> &mine_words, uint64_t seed = 0);
+
+        /**
+         * @brief (Re)places all mines and recalculates the neighbor counts. Only meant to be used
+         * before the first cell has been opened, i. e. to move mines away from the first click.
+         *
+         * @param seed Seed for the mine placement.
+         * @param excluded Flat indices of cells which must not contain a mine.
+         */
+        void Generate(uint64_t seed, const std::vector<int> &excluded = {});
+
+        /**
+         * @brief Regenerates the board so that the given cell and (if possible) its neighbors are
+         * free of mines. Does nothing once a cell has been opened.
+         *
+         * @param row Row index of the first click.
+         * @param col Column index of the first click.
+         * @param seed Seed for the mine placement.
+         */
+        void SafeFirstClick(int row, int col, uint64_t seed);
+
+        /**
+         * @brief Reveals a concealed cell. Revealing a zero cell opens the surrounding area,
+         * revealing a mine ends the game.
+         *
+         * @param row Row index of the cell.
+         * @param col Column index of the cell.
+         * @return RevealResult What happened to the board.
+         */
+        RevealResult Reveal(int row, int col);
+
+        /**
+         * @brief Toggles the flag on a concealed cell.
+         *
+         * @param row Row index of the cell.
+         * @param col Column index of the cell.
+         * @return true The flag count changed.
+         * @return false The cell was not valid or not concealed.
+         */
+        bool ToggleFlag(int row, int col);
+
+        /**
+         * @brief Performs the (iterative, scanline based) flood fill algorithm starting from a given cell.
+         * The opened cells are appended to `LastOpened()` in the order they were opened.
+         *
+         * @param row Row index of the start cell.
+         * @param col Column index of the start cell.
+         * @return int Number of cells opened.
+         */
+        int FloodFill(int row, int col);
+
+        /**
+         * @brief Starts a new game on the same board size: conceals every cell, removes the flags
+         * and places the mines again. The storage is reused, i. e. for playing many games in a row.
+         *
+         * @param seed Seed for the mine placement.
+         * @param excluded Flat indices of cells which must not contain a mine.
+         */
+        void Reset(uint64_t seed, const std::vector<int> &excluded = {});
+
+        /**
+         * @brief Reveals all mines and all flagged cells (end of game).
+         *
+         */
+        void RevealAll();
+
+        /**
+         * @brief Returns the play state (opened cells and flags) of the board.
+         *
+         */
+        BoardState SaveState() const;
+
+        /**
+         * @brief Restores a play state returned by `SaveState()` of a board with the same layout.
+         *
+         * @param state State to restore.
+         */
+        void RestoreState(const BoardState &state);
+
+        /**
+         * @brief Checks if the row and column indices lie within the board.
+         *
+         * @param row Target row index
+         * @param col Target column index
+         * @return true If row and column are within the board bounds
+         * @return false If row or column are not within board bounds
+         */
+        inline bool IsValid(int row, int col) const
+        {
+            return row >= 0 && row < rows && col >= 0 && col < columns;
+        }
+
+        /**
+         * @brief Returns the cell on a given position. The position has to be valid.
+         *
+         * @param row Row index of the cell.
+         * @param col Column index of the cell.
+         * @return const Cell& Cell on the given position.
+         */
+        inline const Cell &At(int row, int col) const
+        {
+            return cells[row * columns + col];
+        }
+
+        /**
+         * @brief Checks if the winning condition was met (all cells without a mine are open).
+         *
+         * @return true Player won the game.
+         * @return false Player did not (yet) win the game.
+         */
+        inline bool Won() const
+        {
+            return !lost && rows * columns - open_count == mines;
+        }
+
+        /**
+         * @brief Checks if a mine has been revealed.
+         *
+         * @return true Game is lost.
+         * @return false Game is not lost.
+         */
+        inline bool Lost() const { return lost; }
+
+        inline int Rows() const { return rows; }
+        inline int Columns() const { return columns; }
+        inline int MineCount() const { return mines; }
+        inline int FlagCount() const { return flag_count; }
+        inline int OpenCount() const { return open_count; }
+        inline uint64_t Seed() const { return seed; }
+
+        /**
+         * @brief Returns the flat (row * columns + col) indices of the cells opened by the last
+         * `Reveal`/`FloodFill` call, in the order they were opened.
+         *
+         * @return const std::vector<int>& Opened cell indices.
+         */
+        inline const std::vector<int> &LastOpened() const { return last_opened; }
+
+        /**
+         * @brief Returns the mine, revealed and flag bit planes, which are kept in sync with the cells.
+         *
+         * @return const BitBoard& Bit planes of the board.
+         */
+        inline const BitBoard &Bits() const { return bits; }
+
+    private:
+        int rows;
+        int columns;
+        int mines;
+        int open_count = 0;
+        int flag_count = 0;
+        bool lost = false;
+        uint64_t seed = 0;
+        std::vector<Cell> cells;
+        BitBoard bits;
+        std::vector<int> last_opened;
+
+        /**
+         * @brief Horizontal run of zero cells on one row, used as flood fill work item.
+         *
+         */
+        struct Span
+        {
+            int row;
+            int left;
+            int right;
+        };
+        std::vector<Span> fill_stack;
+
+        inline Cell &CellAt(int row, int col) { return cells[row * columns + col]; }
+        inline bool Fillable(const Cell &cell) const { return cell.concealed && !cell.flagged && !cell.mine && cell.neighbor_mines == 0; }
+        void Open(int index);
+        void SetMines(const uint8_t *plane);
+        void PushSpan(int row, int col);
+    };
+}
+
+#endif
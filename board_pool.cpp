@@ -0,0 +1,98 @@
+#include "board_pool.h"
+#include "no_guess.h"
+#include "rng.h"
+#include <random>
+
+namespace minis
+{
+    BoardPool::BoardPool(int boards_per_level, int threads)
+        : boards_per_level(boards_per_level), next_seed(Rng(std::random_device{}()).Next())
+    {
+        for (int i = 0; i < threads; i++)
+            workers.emplace_back(&BoardPool::Work, this);
+    }
+
+    BoardPool::~BoardPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+
+        for (std::thread &worker : workers)
+            worker.join();
+    }
+
+    bool BoardPool::Take(DifficultyLevel level, Board *board)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (ready[level].empty())
+                return false;
+
+            *board = std::move(ready[level].front());
+            ready[level].pop_front();
+        }
+        wake.notify_one();
+        return true;
+    }
+
+    int BoardPool::Ready(DifficultyLevel level)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return (int)ready[level].size();
+    }
+
+    /**
+     * @brief Returns the level with the fewest ready (or pending) boards, -1 if all queues are full.
+     * Has to be called with the mutex held.
+     *
+     */
+    int BoardPool::NextLevel() const
+    {
+        int level = -1;
+        int lowest = boards_per_level;
+
+        for (int i = 0; i < DIFFICULTY_LEVEL_COUNT; i++)
+        {
+            int queued = (int)ready[i].size() + pending[i];
+            if (queued < lowest)
+            {
+                lowest = queued;
+                level = i;
+            }
+        }
+
+        return level;
+    }
+
+    void BoardPool::Work()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+
+        while (!stopping)
+        {
+            int level = NextLevel();
+            if (level < 0)
+            {
+                wake.wait(lock);
+                continue;
+            }
+
+            pending[level]++;
+            uint64_t seed = next_seed++;
+            lock.unlock();
+
+            GameSettings settings = GetSettings((DifficultyLevel)level);
+            Board board;
+            // Out of attempts, the next round tries again with another seed
+            bool generated = GenerateNoGuess(settings.rows, settings.columns, settings.mines, seed, &board);
+
+            lock.lock();
+            pending[level]--;
+            if (generated)
+                ready[level].push_back(std::move(board));
+        }
+    }
+}
@@ -0,0 +1,72 @@
+#ifndef BOARD_POOL_H
+#define BOARD_POOL_H
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+#include "board.h"
+#include "settings.h"
+
+namespace minis
+{
+    /**
+     * @brief Generates boards which can be solved without guessing on worker threads and keeps a
+     * small queue of ready boards for every difficulty level, so starting a game rarely waits for
+     * the generator and never runs it on the UI thread.
+     *
+     */
+    class BoardPool
+    {
+    public:
+        /**
+         * @brief Construct a new BoardPool object and start the workers.
+         *
+         * @param boards_per_level Number of ready boards kept for every difficulty level.
+         * @param threads Number of worker threads.
+         */
+        BoardPool(int boards_per_level, int threads);
+
+        /**
+         * @brief Stops the workers and waits for them to finish their current board.
+         *
+         */
+        ~BoardPool();
+
+        BoardPool(const BoardPool &) = delete;
+        BoardPool &operator=(const BoardPool &) = delete;
+
+        /**
+         * @brief Takes a ready board without waiting. The workers refill the queue in the background.
+         *
+         * @param level Difficulty level of the board.
+         * @param board Receives the board.
+         * @return true A board was ready.
+         * @return false The queue of that level is empty.
+         */
+        bool Take(DifficultyLevel level, Board *board);
+
+        /**
+         * @brief Returns the number of ready boards of a difficulty level.
+         *
+         */
+        int Ready(DifficultyLevel level);
+
+    private:
+        int boards_per_level;
+        uint64_t next_seed;
+        bool stopping = false;
+        std::deque<Board> ready[DIFFICULTY_LEVEL_COUNT];
+        int pending[DIFFICULTY_LEVEL_COUNT] = {};
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::vector<std::thread> workers;
+
+        int NextLevel() const;
+        void Work();
+    };
+}
+
+#endif
@@ -0,0 +1,91 @@
+#ifndef BOARD_QUADS_H
+#define BOARD_QUADS_H
+
+#include <cstdint>
+#include "board.h"
+#include "cell_sprite.h"
+#include "grid_layout.h"
+#include "mine_probability.h"
+
+// Alpha of the heatmap tint over the tiles
+#define HEATMAP_ALPHA 110
+
+namespace minis
+{
+    /**
+     * @brief Tint of the quads, same layout as raylib's `Color`.
+     *
+     */
+    struct QuadColor
+    {
+        uint8_t r;
+        uint8_t g;
+        uint8_t b;
+        uint8_t a;
+    };
+
+    /**
+     * @brief Emits the visible cells of any board with `At(row, col)` and `Lost()` as atlas
+     * quads, followed by the closing grid lines on the right and bottom border.
+     * The quads go to a sink with `Tint(QuadColor)` and `Quad(x, y, width, height, Sprite)`:
+     * `BoardRenderer` turns them into one rlgl quad stream, tests count them without a window.
+     *
+     * @param board Board to draw.
+     * @param layout Geometry of the board.
+     * @param visible Cells to emit, the others are skipped.
+     * @param sink Receives the tints and quads.
+     */
+    template <typename AnyBoard, typename Sink>
+    void EmitBoardQuads(AnyBoard &board, const GridLayout &layout, const GridRange &visible, Sink &sink)
+    {
+        bool game_over = board.Lost();
+
+        sink.Tint(QuadColor{255, 255, 255, 255});
+        for (int row = visible.first_row; row < visible.end_row; row++)
+        {
+            float y = layout.CellY(row);
+            for (int col = visible.first_col; col < visible.end_col; col++)
+                sink.Quad(layout.CellX(col), y, layout.tile_size, layout.tile_size, CellSprite(board.At(row, col), game_over));
+        }
+
+        // Same gray as the grid lines inside of the sprites
+        sink.Tint(QuadColor{200, 200, 200, 255});
+        sink.Quad(layout.x + layout.Width(), layout.y, 1.0f, layout.Height() + 1.0f, SPRITE_SOLID);
+        sink.Quad(layout.x, layout.y + layout.Height(), layout.Width(), 1.0f, SPRITE_SOLID);
+    }
+
+    /**
+     * @brief Emits the heatmap over the visible cells: every concealed, unflagged cell gets a solid
+     * quad tinted from green (certainly safe) to red (certainly a mine). Cells with only the mine
+     * density (`MineProbability::Approximated`) are tinted gray instead. Uses the same sink as
+     * `EmitBoardQuads`, so the heatmap stays in the batch of the tiles.
+     *
+     * @param board Board the probabilities belong to.
+     * @param probability Probabilities after `MineProbability::Update`.
+     * @param layout Geometry of the board.
+     * @param visible Cells to emit, the others are skipped.
+     * @param sink Receives the tints and quads.
+     */
+    template <typename Sink>
+    void EmitHeatmapQuads(const Board &board, const MineProbability &probability, const GridLayout &layout, const GridRange &visible, Sink &sink)
+    {
+        for (int row = visible.first_row; row < visible.end_row; row++)
+        {
+            for (int col = visible.first_col; col < visible.end_col; col++)
+            {
+                const Cell &cell = board.At(row, col);
+                if (!cell.concealed || cell.flagged)
+                    continue;
+
+                float mine_probability = probability.At(row, col);
+                if (probability.Approximated(row * layout.columns + col))
+                    sink.Tint(QuadColor{128, 128, 128, HEATMAP_ALPHA});
+                else
+                    sink.Tint(QuadColor{(uint8_t)(255 * mine_probability), (uint8_t)(255 * (1.0f - mine_probability)), 0, HEATMAP_ALPHA});
+                sink.Quad(layout.CellX(col), layout.CellY(row), layout.tile_size, layout.tile_size, SPRITE_SOLID);
+            }
+        }
+    }
+}
+
+#endif
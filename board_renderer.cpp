@@ -0,0 +1,66 @@
+#include "board_renderer.h"
+#include "rlgl.h"
+
+namespace minis
+{
+    BoardRenderer::BoardRenderer(Texture2D atlas, int tile_size) : atlas(atlas), tile_size(tile_size)
+    {
+    }
+
+    void BoardRenderer::BatchSink::Tint(QuadColor color)
+    {
+        rlColor4ub(color.r, color.g, color.b, color.a);
+    }
+
+    /**
+     * @brief Adds one textured quad to the current render batch, flushing the batch when it is full.
+     *
+     */
+    void BoardRenderer::BatchSink::Quad(float x, float y, float width, float height, Sprite sprite)
+    {
+        if (rlCheckRenderBatchLimit(4))
+            renderer.draw_calls++;
+
+        // Sample a little inside of the sprite so neighboring sprites never bleed in
+        float u0 = (sprite * renderer.tile_size + 0.01f) / renderer.atlas.width;
+        float u1 = ((sprite + 1) * renderer.tile_size - 0.01f) / renderer.atlas.width;
+
+        rlBegin(RL_QUADS);
+        rlNormal3f(0.0f, 0.0f, 1.0f);
+        rlTexCoord2f(u0, 0.0f);
+        rlVertex2f(x, y);
+        rlTexCoord2f(u0, 1.0f);
+        rlVertex2f(x, y + height);
+        rlTexCoord2f(u1, 1.0f);
+        rlVertex2f(x + width, y + height);
+        rlTexCoord2f(u1, 0.0f);
+        rlVertex2f(x + width, y);
+        rlEnd();
+    }
+
+    void BoardRenderer::Draw(const Board &board, const GridLayout &layout, const GridRange &visible)
+    {
+        BatchSink sink{*this};
+        draw_calls = 1;
+        rlSetTexture(atlas.id);
+        EmitBoardQuads(board, layout, visible, sink);
+        rlSetTexture(0);
+    }
+
+    void BoardRenderer::Draw(ChunkedBoard &board, const GridLayout &layout, const GridRange &visible)
+    {
+        BatchSink sink{*this};
+        draw_calls = 1;
+        rlSetTexture(atlas.id);
+        EmitBoardQuads(board, layout, visible, sink);
+        rlSetTexture(0);
+    }
+
+    void BoardRenderer::DrawHeatmap(const Board &board, const MineProbability &probability, const GridLayout &layout, const GridRange &visible)
+    {
+        BatchSink sink{*this};
+        rlSetTexture(atlas.id);
+        EmitHeatmapQuads(board, probability, layout, visible, sink);
+        rlSetTexture(0);
+    }
+}
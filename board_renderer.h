@@ -0,0 +1,88 @@
+#ifndef BOARD_RENDERER_H
+#define BOARD_RENDERER_H
+
+#include "raylib.h"
+#include "board.h"
+#include "chunked_board.h"
+#include "grid_layout.h"
+#include "board_quads.h"
+
+namespace minis
+{
+    /**
+     * @brief Draws a board from a single texture atlas holding the tile, flag, mine, cross and number
+     * sprites. All tiles (and the grid lines, which are part of the sprites) are emitted as one quad
+     * stream against that atlas, so a whole board costs one draw call per filled render batch.
+     * The quads themselves come from `EmitBoardQuads` and `EmitHeatmapQuads`, the renderer is their
+     * rlgl sink.
+     *
+     */
+    class BoardRenderer
+    {
+    public:
+        /**
+         * @brief Construct a new BoardRenderer object.
+         *
+         * @param atlas Tile atlas, see `AssetCache::TileAtlas`. It is not owned by the renderer.
+         * @param tile_size Pixel size of a tile in the atlas.
+         */
+        BoardRenderer(Texture2D atlas, int tile_size);
+
+        BoardRenderer(const BoardRenderer &) = delete;
+        BoardRenderer &operator=(const BoardRenderer &) = delete;
+
+        /**
+         * @brief Draws the visible part of the board.
+         *
+         * @param board Board to draw.
+         * @param layout Geometry of the board.
+         * @param visible Cells to draw, the others are skipped.
+         */
+        void Draw(const Board &board, const GridLayout &layout, const GridRange &visible);
+
+        /**
+         * @brief Draws the visible part of a marathon board, creating the chunks in view.
+         *
+         * @param board Board to draw.
+         * @param layout Geometry of the board.
+         * @param visible Cells to draw, the others are skipped.
+         */
+        void Draw(ChunkedBoard &board, const GridLayout &layout, const GridRange &visible);
+
+        /**
+         * @brief Draws the mine probabilities over the visible part of the board, in the batch of the tiles.
+         *
+         * @param board Board to draw.
+         * @param probability Probabilities after `MineProbability::Update`.
+         * @param layout Geometry of the board.
+         * @param visible Cells to draw, the others are skipped.
+         */
+        void DrawHeatmap(const Board &board, const MineProbability &probability, const GridLayout &layout, const GridRange &visible);
+
+        /**
+         * @brief Returns the number of draw calls the last `Draw` issued.
+         *
+         * @return int Number of draw calls.
+         */
+        inline int DrawCalls() const { return draw_calls; }
+
+    private:
+        Texture2D atlas;
+        int tile_size;
+        int draw_calls = 0;
+
+        /**
+         * @brief Sink of `EmitBoardQuads`, adds the quads to the current render batch.
+         *
+         */
+        struct BatchSink
+        {
+            BoardRenderer &renderer;
+
+            void Tint(QuadColor color);
+            void Quad(float x, float y, float width, float height, Sprite sprite);
+        };
+    };
+}
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef CELL_SPRITE_H
+#define CELL_SPRITE_H
+
+#include "board.h"
+
+namespace minis
+{
+    /**
+     * @brief Sprites packed into the tile atlas, one tile size wide each.
+     *
+     */
+    enum Sprite
+    {
+        SPRITE_CONCEALED = 0,
+        SPRITE_FLAG,
+        SPRITE_OPEN,
+        SPRITE_MINE,
+        SPRITE_MINE_TRIGGERED,
+        SPRITE_WRONG_FLAG,
+        SPRITE_SOLID,
+        SPRITE_NUMBER_1,
+        SPRITE_COUNT = SPRITE_NUMBER_1 + 8,
+    };
+
+    /**
+     * @brief Returns the sprite representing a cell.
+     *
+     * @param cell Gameplay state of the cell.
+     * @param game_over Game over state of the board.
+     * @return Sprite Sprite to draw for the cell.
+     */
+    inline Sprite CellSprite(const Cell &cell, bool game_over)
+    {
+        if (cell.concealed && cell.flagged)
+            return SPRITE_FLAG;
+        if (game_over && cell.flagged && !cell.mine)
+            return SPRITE_WRONG_FLAG;
+        if (cell.concealed)
+            return SPRITE_CONCEALED;
+        if (cell.mine)
+            return cell.triggered ? SPRITE_MINE_TRIGGERED : SPRITE_MINE;
+        if (cell.neighbor_mines > 0)
+            return (Sprite)(SPRITE_NUMBER_1 + cell.neighbor_mines - 1);
+        return SPRITE_OPEN;
+    }
+}
+
+#endif
@@ -0,0 +1,280 @@
+#include "chunked_board.h"
+#include "rng.h"
+#include "mine_placement.h"
+#include "neighbor_count.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace minis
+{
+    ChunkedBoard::ChunkedBoard(int64_t chunk_rows, int64_t chunk_columns, int mines_per_chunk, uint64_t seed)
+        : chunk_rows(chunk_rows), chunk_columns(chunk_columns), mines_per_chunk(mines_per_chunk), seed(seed)
+    {
+        if (chunk_rows < 1 || chunk_columns < 1)
+            throw("Unable to create a board with less than 1 chunk row or column.");
+        // Keep room for the 3x3 safe zone of the first click in every chunk
+        if (mines_per_chunk < 0 || mines_per_chunk > CHUNK_SIZE * CHUNK_SIZE - 9)
+            throw("Unable to place that many mines in a chunk.");
+    }
+
+    /**
+     * @brief Creates the mine layout of a chunk from its seed (one byte per cell, row-major).
+     *
+     * @param chunk_row Chunk row index.
+     * @param chunk_col Chunk column index.
+     * @param plane Receives CHUNK_SIZE * CHUNK_SIZE bytes.
+     */
+    void ChunkedBoard::MinePlane(int64_t chunk_row, int64_t chunk_col, uint8_t *plane) const
+    {
+        std::vector<int> excluded;
+        if (has_safe_zone)
+        {
+            for (int64_t row = safe_row - 1; row <= safe_row + 1; row++)
+            {
+                for (int64_t col = safe_col - 1; col <= safe_col + 1; col++)
+                {
+                    if (IsValid(row, col) && row / CHUNK_SIZE == chunk_row && col / CHUNK_SIZE == chunk_col)
+                        excluded.push_back((int)(row % CHUNK_SIZE) * CHUNK_SIZE + (int)(col % CHUNK_SIZE));
+                }
+            }
+        }
+
+        Rng rng(seed ^ Rng(ChunkKey(chunk_row, chunk_col)).Next());
+        std::fill(plane, plane + CHUNK_SIZE * CHUNK_SIZE, 0);
+        PlaceMines(plane, CHUNK_SIZE * CHUNK_SIZE, mines_per_chunk, excluded, rng);
+    }
+
+    /**
+     * @brief Returns a chunk, creating it (mines and neighbor counts) on first access.
+     *
+     * @param chunk_row Chunk row index.
+     * @param chunk_col Chunk column index.
+     * @return Chunk& The chunk.
+     */
+    ChunkedBoard::Chunk &ChunkedBoard::GetChunk(int64_t chunk_row, int64_t chunk_col)
+    {
+        uint64_t key = ChunkKey(chunk_row, chunk_col);
+        if (key == cached_key)
+            return *cached_chunk;
+
+        auto found = chunks.find(key);
+        if (found == chunks.end())
+        {
+            const int size = CHUNK_SIZE;
+            const int padded_size = CHUNK_SIZE + 2;
+            std::vector<uint8_t> plane(size * size);
+            std::vector<uint8_t> padded(padded_size * padded_size, 0);
+            std::vector<uint8_t> counts(padded_size * padded_size);
+
+            // Own mines plus the border rows/columns of the eight adjacent chunks
+            for (int d_row = -1; d_row <= 1; d_row++)
+            {
+                for (int d_col = -1; d_col <= 1; d_col++)
+                {
+                    int64_t neighbor_row = chunk_row + d_row;
+                    int64_t neighbor_col = chunk_col + d_col;
+                    if (neighbor_row < 0 || neighbor_row >= chunk_rows || neighbor_col < 0 || neighbor_col >= chunk_columns)
+                        continue;
+
+                    MinePlane(neighbor_row, neighbor_col, plane.data());
+                    for (int row = 0; row < size; row++)
+                    {
+                        int padded_row = row + 1 + d_row * size;
+                        if (padded_row < 0 || padded_row >= padded_size)
+                            continue;
+                        for (int col = 0; col < size; col++)
+                        {
+                            int padded_col = col + 1 + d_col * size;
+                            if (padded_col >= 0 && padded_col < padded_size)
+                                padded[padded_row * padded_size + padded_col] = plane[row * size + col];
+                        }
+                    }
+                }
+            }
+
+            CountNeighborMines(padded.data(), padded_size, padded_size, counts.data());
+
+            Chunk chunk;
+            chunk.cells.resize(size * size);
+            for (int row = 0; row < size; row++)
+            {
+                for (int col = 0; col < size; col++)
+                {
+                    int index = (row + 1) * padded_size + col + 1;
+                    Cell &cell = chunk.cells[row * size + col];
+                    cell.mine = padded[index];
+                    cell.neighbor_mines = counts[index];
+                    // Chunks created after the game is lost show their mines right away
+                    if (lost && cell.mine)
+                        cell.concealed = false;
+                }
+            }
+
+            found = chunks.emplace(key, std::move(chunk)).first;
+        }
+
+        cached_key = key;
+        cached_chunk = &found->second;
+        return found->second;
+    }
+
+    Cell &ChunkedBoard::CellRef(int64_t row, int64_t col, Chunk **chunk)
+    {
+        Chunk &owner = GetChunk(row / CHUNK_SIZE, col / CHUNK_SIZE);
+        if (chunk)
+            *chunk = &owner;
+        return owner.cells[(row % CHUNK_SIZE) * CHUNK_SIZE + (col % CHUNK_SIZE)];
+    }
+
+    const Cell &ChunkedBoard::At(int64_t row, int64_t col)
+    {
+        return CellRef(row, col);
+    }
+
+    void ChunkedBoard::Open(Cell &cell, Chunk *chunk)
+    {
+        cell.concealed = false;
+        chunk->touched = true;
+        open_count++;
+    }
+
+    void ChunkedBoard::SafeFirstClick(int64_t row, int64_t col)
+    {
+        if (open_count > 0 || lost || !IsValid(row, col))
+            return;
+
+        // Untouched chunks are regenerated on demand, flagged ones have to keep their flags
+        has_safe_zone = true;
+        safe_row = row;
+        safe_col = col;
+
+        std::unordered_map<uint64_t, Chunk> old_chunks;
+        old_chunks.swap(chunks);
+        cached_key = UINT64_MAX;
+        cached_chunk = nullptr;
+
+        for (auto &entry : old_chunks)
+        {
+            if (!entry.second.touched)
+                continue;
+
+            int64_t chunk_row = entry.first / chunk_columns;
+            int64_t chunk_col = entry.first % chunk_columns;
+            Chunk &chunk = GetChunk(chunk_row, chunk_col);
+            for (size_t i = 0; i < chunk.cells.size(); i++)
+                chunk.cells[i].flagged = entry.second.cells[i].flagged;
+            chunk.touched = true;
+        }
+    }
+
+    RevealResult ChunkedBoard::Reveal(int64_t row, int64_t col)
+    {
+        if (lost || Won() || !IsValid(row, col))
+            return RevealResult::Ignored;
+
+        Chunk *chunk;
+        Cell &cell = CellRef(row, col, &chunk);
+        if (!cell.concealed || cell.flagged)
+            return RevealResult::Ignored;
+
+        if (cell.mine)
+        {
+            cell.concealed = false;
+            cell.triggered = true;
+            chunk->touched = true;
+            lost = true;
+
+            // Reveal the mines of all loaded chunks, the others show them once they are created
+            for (auto &entry : chunks)
+            {
+                for (Cell &other : entry.second.cells)
+                {
+                    if (other.mine || other.flagged)
+                        other.concealed = false;
+                }
+            }
+            return RevealResult::Exploded;
+        }
+
+        Open(cell, chunk);
+        fill_stack.clear();
+        if (cell.neighbor_mines == 0)
+            fill_stack.push_back({row, col});
+
+        // Iterative flood fill, every cell is opened when it is pushed so it is pushed at most once
+        while (!fill_stack.empty())
+        {
+            std::pair<int64_t, int64_t> current = fill_stack.back();
+            fill_stack.pop_back();
+
+            for (int d_row = -1; d_row <= 1; d_row++)
+            {
+                for (int d_col = -1; d_col <= 1; d_col++)
+                {
+                    int64_t r = current.first + d_row;
+                    int64_t c = current.second + d_col;
+                    if ((d_row == 0 && d_col == 0) || !IsValid(r, c))
+                        continue;
+
+                    Chunk *neighbor_chunk;
+                    Cell &neighbor = CellRef(r, c, &neighbor_chunk);
+                    if (!neighbor.concealed || neighbor.flagged || neighbor.mine)
+                        continue;
+
+                    Open(neighbor, neighbor_chunk);
+                    if (neighbor.neighbor_mines == 0)
+                        fill_stack.push_back({r, c});
+                }
+            }
+        }
+
+        return RevealResult::Opened;
+    }
+
+    bool ChunkedBoard::ToggleFlag(int64_t row, int64_t col)
+    {
+        if (!IsValid(row, col))
+            return false;
+
+        Chunk *chunk;
+        Cell &cell = CellRef(row, col, &chunk);
+        if (!cell.concealed)
+            return false;
+
+        cell.flagged = !cell.flagged;
+        chunk->touched = true;
+        flag_count += cell.flagged ? 1 : -1;
+        return true;
+    }
+
+    int ChunkedBoard::EvictFarChunks(int64_t row, int64_t col, int radius)
+    {
+        int64_t center_row = row / CHUNK_SIZE;
+        int64_t center_col = col / CHUNK_SIZE;
+        int evicted = 0;
+
+        for (auto entry = chunks.begin(); entry != chunks.end();)
+        {
+            int64_t chunk_row = entry->first / chunk_columns;
+            int64_t chunk_col = entry->first % chunk_columns;
+
+            if (!entry->second.touched &&
+                (std::llabs(chunk_row - center_row) > radius || std::llabs(chunk_col - center_col) > radius))
+            {
+                if (&entry->second == cached_chunk)
+                {
+                    cached_key = UINT64_MAX;
+                    cached_chunk = nullptr;
+                }
+                entry = chunks.erase(entry);
+                evicted++;
+            }
+            else
+            {
+                ++entry;
+            }
+        }
+
+        return evicted;
+    }
+}
@@ -0,0 +1,134 @@
+#ifndef CHUNKED_BOARD_H
+#define CHUNKED_BOARD_H
+
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+#include "board.h"
+
+namespace minis
+{
+    /**
+     * @brief Board for the "marathon" mode. The board is split into square chunks which are only
+     * created on first access. The mines of a chunk are derived from a per-chunk seed, so a chunk can
+     * be dropped and recreated at any time as long as the player has not touched it (opened or
+     * flagged a cell in it). Neighbor counts at chunk borders are calculated from the (recreated)
+     * mine layout of the adjacent chunks, so they are always consistent.
+     * Memory use grows with the explored area, not with the nominal board size.
+     *
+     */
+    class ChunkedBoard
+    {
+    public:
+        static const int CHUNK_SIZE = 64;
+
+        /**
+         * @brief Construct a new ChunkedBoard object. No chunk is created yet.
+         *
+         * @param chunk_rows Number of chunk rows, the board has `chunk_rows * CHUNK_SIZE` rows.
+         * @param chunk_columns Number of chunk columns, the board has `chunk_columns * CHUNK_SIZE` columns.
+         * @param mines_per_chunk Number of mines in every chunk.
+         * @param seed Seed of the board, every chunk seed is derived from it.
+         */
+        ChunkedBoard(int64_t chunk_rows, int64_t chunk_columns, int mines_per_chunk, uint64_t seed);
+
+        /**
+         * @brief Reveals a concealed cell. Revealing a zero cell opens the surrounding area (across
+         * chunk borders), revealing a mine ends the game.
+         *
+         * @param row Row index of the cell.
+         * @param col Column index of the cell.
+         * @return RevealResult What happened to the board.
+         */
+        RevealResult Reveal(int64_t row, int64_t col);
+
+        /**
+         * @brief Toggles the flag on a concealed cell.
+         *
+         * @param row Row index of the cell.
+         * @param col Column index of the cell.
+         * @return true The flag count changed.
+         * @return false The cell was not valid or not concealed.
+         */
+        bool ToggleFlag(int64_t row, int64_t col);
+
+        /**
+         * @brief Moves the mines away from the first click and its neighbors by dropping all chunks
+         * and excluding the zone from every future chunk generation. Does nothing once a cell has
+         * been opened.
+         *
+         * @param row Row index of the first click.
+         * @param col Column index of the first click.
+         */
+        void SafeFirstClick(int64_t row, int64_t col);
+
+        /**
+         * @brief Returns the cell on a given (valid) position, creating its chunk if necessary.
+         *
+         * @param row Row index of the cell.
+         * @param col Column index of the cell.
+         * @return const Cell& Cell on the given position.
+         */
+        const Cell &At(int64_t row, int64_t col);
+
+        /**
+         * @brief Drops all untouched chunks which are more than `radius` chunks away from a cell.
+         *
+         * @param row Row index of the center cell (i. e. the center of the view).
+         * @param col Column index of the center cell.
+         * @param radius Number of chunks around the center chunk which are kept.
+         * @return int Number of chunks evicted.
+         */
+        int EvictFarChunks(int64_t row, int64_t col, int radius);
+
+        inline bool IsValid(int64_t row, int64_t col) const
+        {
+            return row >= 0 && row < Rows() && col >= 0 && col < Columns();
+        }
+
+        inline bool Won() const { return !lost && Rows() * Columns() - open_count == MineCount(); }
+        inline bool Lost() const { return lost; }
+        inline int64_t Rows() const { return chunk_rows * CHUNK_SIZE; }
+        inline int64_t Columns() const { return chunk_columns * CHUNK_SIZE; }
+        inline int64_t MineCount() const { return chunk_rows * chunk_columns * mines_per_chunk; }
+        inline int64_t FlagCount() const { return flag_count; }
+        inline int64_t OpenCount() const { return open_count; }
+        inline size_t LoadedChunks() const { return chunks.size(); }
+
+    private:
+        struct Chunk
+        {
+            std::vector<Cell> cells;
+            bool touched = false;
+        };
+
+        int64_t chunk_rows;
+        int64_t chunk_columns;
+        int mines_per_chunk;
+        uint64_t seed;
+        int64_t open_count = 0;
+        int64_t flag_count = 0;
+        bool lost = false;
+
+        bool has_safe_zone = false;
+        int64_t safe_row = 0;
+        int64_t safe_col = 0;
+
+        std::unordered_map<uint64_t, Chunk> chunks;
+        uint64_t cached_key = UINT64_MAX;
+        Chunk *cached_chunk = nullptr;
+        std::vector<std::pair<int64_t, int64_t>> fill_stack;
+
+        inline uint64_t ChunkKey(int64_t chunk_row, int64_t chunk_col) const
+        {
+            return (uint64_t)chunk_row * (uint64_t)chunk_columns + (uint64_t)chunk_col;
+        }
+
+        Chunk &GetChunk(int64_t chunk_row, int64_t chunk_col);
+        Cell &CellRef(int64_t row, int64_t col, Chunk **chunk = nullptr);
+        void MinePlane(int64_t chunk_row, int64_t chunk_col, uint8_t *plane) const;
+        void Open(Cell &cell, Chunk *chunk);
+    };
+}
+
+#endif
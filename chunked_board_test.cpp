@@ -0,0 +1,134 @@
+#include <cstdio>
+#include <vector>
+#include "chunked_board.h"
+#include "rng.h"
+
+using namespace ::minis;
+
+#define TEST_CHUNKS 3
+#define TEST_MINES_PER_CHUNK 800
+
+static int failed = 0;
+
+static void Check(bool condition, const char *what)
+{
+    if (condition)
+        return;
+    printf("FAILED: %s\n", what);
+    failed++;
+}
+
+/**
+ * @brief Returns true if every neighbor count (chunk borders included) matches the mines around it.
+ *
+ */
+static bool CountsConsistent(ChunkedBoard &board)
+{
+    for (int64_t row = 0; row < board.Rows(); row++)
+    {
+        for (int64_t col = 0; col < board.Columns(); col++)
+        {
+            int count = 0;
+            for (int64_t r = row - 1; r <= row + 1; r++)
+            {
+                for (int64_t c = col - 1; c <= col + 1; c++)
+                    count += (r != row || c != col) && board.IsValid(r, c) && board.At(r, c).mine;
+            }
+            if (count != board.At(row, col).neighbor_mines)
+            {
+                printf("cell %lld, %lld counts %d mines, %d around it\n", (long long)row, (long long)col,
+                       board.At(row, col).neighbor_mines, count);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Returns the mines and counts of every cell, which creates all chunks.
+ *
+ */
+static std::vector<int> Layout(ChunkedBoard &board)
+{
+    std::vector<int> layout;
+    for (int64_t row = 0; row < board.Rows(); row++)
+    {
+        for (int64_t col = 0; col < board.Columns(); col++)
+            layout.push_back(board.At(row, col).mine * 16 + board.At(row, col).neighbor_mines);
+    }
+    return layout;
+}
+
+static void TestBorderCounts()
+{
+    for (uint64_t seed = 1; seed <= 4; seed++)
+    {
+        ChunkedBoard board(TEST_CHUNKS, TEST_CHUNKS, TEST_MINES_PER_CHUNK, seed);
+        Check(CountsConsistent(board), "neighbor counts match the mines across chunk borders");
+        Check(board.LoadedChunks() == TEST_CHUNKS * TEST_CHUNKS, "every chunk is created on access");
+    }
+}
+
+static void TestEviction()
+{
+    ChunkedBoard board(TEST_CHUNKS, TEST_CHUNKS, TEST_MINES_PER_CHUNK, 7);
+    std::vector<int> before = Layout(board);
+
+    // A flag in the far corner keeps its chunk, the rest is dropped
+    int64_t last = board.Rows() - 1;
+    board.ToggleFlag(last, last);
+    int evicted = board.EvictFarChunks(0, 0, 0);
+    Check(evicted == TEST_CHUNKS * TEST_CHUNKS - 2, "untouched chunks out of the radius are evicted");
+    Check(board.LoadedChunks() == 2, "the center chunk and the touched chunk stay");
+    Check(board.At(last, last).flagged, "the flag survives the eviction");
+
+    board.ToggleFlag(last, last);
+    Check(Layout(board) == before, "evicted chunks are recreated identically");
+    Check(CountsConsistent(board), "neighbor counts match after the chunks were recreated");
+}
+
+static void TestSafeFirstClick()
+{
+    // Clicks next to chunk corners spread the safe zone over up to four chunks
+    const int64_t corners[4][2] = {{63, 63}, {64, 64}, {64, 63}, {127, 128}};
+    Rng rng(3);
+    for (int game = 0; game < 40; game++)
+    {
+        ChunkedBoard board(TEST_CHUNKS, TEST_CHUNKS, TEST_MINES_PER_CHUNK, rng.Next());
+        bool corner = game % 2 == 1;
+        int64_t row = corner ? corners[game / 2 % 4][0] : (int64_t)rng.Below(board.Rows());
+        int64_t col = corner ? corners[game / 2 % 4][1] : (int64_t)rng.Below(board.Columns());
+
+        board.At(row, col);
+        board.SafeFirstClick(row, col);
+        bool safe = true;
+        for (int64_t r = row - 1; r <= row + 1; r++)
+        {
+            for (int64_t c = col - 1; c <= col + 1; c++)
+                safe = safe && (!board.IsValid(r, c) || !board.At(r, c).mine);
+        }
+        Check(safe, "the first click and its neighbors are free of mines");
+        Check(board.Reveal(row, col) == RevealResult::Opened && board.At(row, col).neighbor_mines == 0, "the first click opens an area");
+        Check(CountsConsistent(board), "neighbor counts match after the safe first click");
+
+        // Eviction and regeneration keep the safe zone
+        board.EvictFarChunks(board.Rows() - 1, board.Columns() - 1, 0);
+        Check(CountsConsistent(board), "neighbor counts match after evicting around the safe zone");
+    }
+}
+
+/**
+ * @brief Checks the chunked marathon board: consistent counts at chunk borders, identical chunks
+ * after eviction and the safe zone of the first click.
+ *
+ */
+int main()
+{
+    TestBorderCounts();
+    TestEviction();
+    TestSafeFirstClick();
+
+    printf("%d checks failed\n", failed);
+    return failed > 0 ? 1 : 0;
+}
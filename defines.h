@@ -1,6 +1,7 @@
 #ifndef DEFINES_H
 #define DEFINES_H
 
+#define TARGET_FPS 60
 #define HEADER_HEIGHT 50
 #define BUTTON_SIZE 40
 #define BUTTON_OFFSET_X 10
@@ -8,11 +9,41 @@
 #define DISPLAY_WIDTH 90
 #define DISPLAY_OFFSET_X 20
 #define DISPLAY_OFFSET_Y 5
+#define DISPLAY_FONT_SIZE 35
 #define COMBOBOX_WIDTH 290
 #define COMBOBOX_HEIGHT 70
 #define INFO_DIALOG_OFFSET 5
 #define MENU_FONT_SIZE 20
-#define START_BUTTON_OFFSET_Y 100
+#define START_BUTTON_OFFSET_Y 120
+#define NO_GUESS_CHECKBOX_OFFSET_Y 80
+#define NO_GUESS_CHECKBOX_SIZE 20
+#define AUTOPLAY_MOVES_PER_FRAME 256
+#define BOARD_POOL_SIZE 2
+#define BOARD_POOL_THREADS 2
+#define REPLAY_MAX_EVENTS_PER_FRAME 64
+#define REPLAY_DIRECTORY "replays"
+#define SNAPSHOT_PATH "minisweeper.sav"
+#define SNAPSHOT_INTERVAL_SECONDS 5
+#define PROFILER_OVERLAY_WIDTH 240
+#define PROFILER_GRAPH_HEIGHT 60
+#define PROFILER_GRAPH_MS 33.3f
+#define PROFILER_FONT_SIZE 10
+#define PROFILER_HISTOGRAM_HEIGHT 40
+#define IDLE_REDRAW_FRAMES 2
+#define VIEW_MIN_TILE_PIXELS 4.0f
+#define VIEW_MAX_ZOOM 4.0f
+#define VIEW_ZOOM_STEP 0.1f
+#define VIEW_PAN_STEP 10.0f
+#define MINIMAP_SIZE 200
+#define MINIMAP_MARGIN 10
+#define WINDOW_MIN_WIDTH 408
+#define WINDOW_MIN_HEIGHT 458
+#define CUSTOM_SPINNER_HEIGHT 30
+#define CUSTOM_SPINNER_SPACING 40
+#define WINDOW_SCREEN_FRACTION 0.9f
+#define MARATHON_CHUNKS 256
+#define MARATHON_MINES_PER_CHUNK 640
+#define MARATHON_CHUNK_MARGIN 1
 
 
 #endif
\ No newline at end of file
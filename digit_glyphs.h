@@ -0,0 +1,67 @@
+#ifndef DIGIT_GLYPHS_H
+#define DIGIT_GLYPHS_H
+
+#include <cstdint>
+
+#define DIGIT_GLYPH_MINUS 10
+#define DIGIT_GLYPH_COUNT 11
+#define DIGIT_GLYPHS_MAX 12
+
+namespace minis
+{
+    /**
+     * @brief Converts a number into glyph indices of the digit atlas (0 to 9 and
+     * `DIGIT_GLYPH_MINUS`), most significant first, without building a string.
+     *
+     * @param value Number to convert.
+     * @param min_digits Pads with leading zeros up to this many digits.
+     * @param glyphs Receives the glyphs, room for `DIGIT_GLYPHS_MAX` entries.
+     * @return int Number of glyphs written.
+     */
+    inline int DigitGlyphs(int value, int min_digits, uint8_t *glyphs)
+    {
+        uint8_t reversed[DIGIT_GLYPHS_MAX];
+        int count = 0;
+        // Negated as unsigned, so INT_MIN does not overflow
+        uint32_t magnitude = value < 0 ? 0u - (uint32_t)value : (uint32_t)value;
+
+        do
+        {
+            reversed[count++] = (uint8_t)(magnitude % 10);
+            magnitude /= 10;
+        } while (magnitude > 0);
+
+        while (count < min_digits && count < DIGIT_GLYPHS_MAX - 1)
+            reversed[count++] = 0;
+
+        int length = 0;
+        if (value < 0)
+            glyphs[length++] = DIGIT_GLYPH_MINUS;
+        while (count > 0)
+            glyphs[length++] = reversed[--count];
+        return length;
+    }
+
+    /**
+     * @brief Lays a number out as glyphs of the digit atlas, left to right from a start position.
+     * The glyphs go to a sink with `Glyph(glyph, x, y)`: `DigitalDisplay` draws them from the
+     * atlas, tests count them without a window.
+     *
+     * @param value Number to show.
+     * @param min_digits Pads with leading zeros up to this many digits.
+     * @param x Horizontal position of the first glyph.
+     * @param y Vertical position of the glyphs.
+     * @param advance Distance from one glyph to the next.
+     * @param sink Receives the glyphs.
+     */
+    template <typename Sink>
+    void EmitDigits(int value, int min_digits, float x, float y, float advance, Sink &sink)
+    {
+        uint8_t glyphs[DIGIT_GLYPHS_MAX];
+        int count = DigitGlyphs(value, min_digits, glyphs);
+        for (int i = 0; i < count; i++)
+            sink.Glyph(glyphs[i], x + i * advance, y);
+    }
+}
+
+#endif
@@ -2,7 +2,7 @@
 
 namespace minis
 {
-    DigitalDisplay::DigitalDisplay(Rectangle bounds) : background(bounds)
+    DigitalDisplay::DigitalDisplay(Rectangle bounds, GlyphAtlas digits) : background(bounds), digits(digits)
     {
         this->inner_background = Rectangle{
             bounds.x + inner_offset, bounds.y + inner_offset,
@@ -11,11 +11,20 @@ namespace minis
 
     void DigitalDisplay::Update() {}
 
-    void DigitalDisplay::Draw(char *text)
+    void DigitalDisplay::Draw(int value, int min_digits)
     {
         DrawRectangle(background.x, background.y, background.width, background.height, DARKGRAY);
         DrawRectangle(inner_background.x, inner_background.y, inner_background.width, inner_background.height, BLACK);
-        DrawText(text, inner_background.x + 2, inner_background.y + 2, 35, GREEN);
+
+        // Same spacing as DrawText with the default font
+        float advance = digits.glyph_width + digits.glyph_height / 10;
+        AtlasSink sink{digits};
+        EmitDigits(value, min_digits, inner_background.x + 2, inner_background.y + 2, advance, sink);
+    }
+
+    void DigitalDisplay::AtlasSink::Glyph(int glyph, float x, float y)
+    {
+        DrawTextureRec(digits.texture, digits.Glyph(glyph), Vector2{x, y}, GREEN);
     }
 
     void DigitalDisplay::SetPosition(Vector2 position)
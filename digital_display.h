@@ -2,21 +2,41 @@
 #define DIGITIAL_DISPLAY_H
 
 #include "raylib.h"
+#include "asset_cache.h"
 
 namespace minis
 {
     class DigitalDisplay
     {
     public:
-        DigitalDisplay(Rectangle bounds);
-        void Draw(char *text);
+        DigitalDisplay(Rectangle bounds, GlyphAtlas digits);
+
+        /**
+         * @brief Draws the display showing a number, digit by digit from the digit atlas.
+         *
+         * @param value Number to show.
+         * @param min_digits Pads with leading zeros up to this many digits.
+         */
+        void Draw(int value, int min_digits);
         void Update();
         void SetPosition(Vector2 position);
 
     private:
         Rectangle background;
         Rectangle inner_background;
+        GlyphAtlas digits;
         int inner_offset = 2;
+
+        /**
+         * @brief Sink of `EmitDigits`, draws the glyphs from the digit atlas.
+         *
+         */
+        struct AtlasSink
+        {
+            const GlyphAtlas &digits;
+
+            void Glyph(int glyph, float x, float y);
+        };
     };
 }
 
@@ -1,5 +1,7 @@
 #include "field.h"
 #include "defines.h"
+#include <random>
+#include <algorithm>
 
 namespace minis
 {
@@ -8,253 +10,207 @@ namespace minis
      *
      * @param position Upper left point the field will be drawn to.
      * @param settings Field settings.
+     * @param assets Asset cache providing the tile atlas.
      */
-    Field::Field(Vector2 position, GameSettings settings)
-        : grid_position(position), settings(settings)
+    Field::Field(Vector2 position, GameSettings settings, AssetCache *assets)
+        : Field(position, settings, Board(settings, std::random_device{}()), assets) {}
+
+    /**
+     * @brief Create a field object on top of an existing board.
+     *
+     * @param position Upper left point the field will be drawn to.
+     * @param settings Field settings.
+     * @param board Board to play on, may already have opened cells.
+     * @param assets Asset cache providing the tile atlas.
+     */
+    Field::Field(Vector2 position, GameSettings settings, Board board, AssetCache *assets)
+        : grid_position(position), settings(settings), board(std::move(board)),
+          solver(this->board), probability(this->board), renderer(assets->TileAtlas(settings.tile_size, settings.font_size), settings.tile_size),
+          recorder(this->board), minimap(this->board)
     {
-        if (settings.columns < 1 || settings.rows < 1)
-            throw("Unable to create a field with less than 1 column or row.");
+        camera = Camera2D{position, Vector2{0.0f, 0.0f}, 0.0f, 1.0f};
+        viewport = Rectangle{position.x, position.y, (float)settings.tile_size * settings.columns, (float)settings.tile_size * settings.rows};
+    }
 
-        // Load Textures
-        if (settings.tile_size == 31)
-        {
-            tile_texture = LoadTexture("assets/tile_31x31.png");
-            flag_texture = LoadTexture("assets/flag_31x31.png");
-            cross_texture = LoadTexture("assets/cross_31x31.png");
-            mine_texture = LoadTexture("assets/mine_31x31.png");
-        }
-        else if (settings.tile_size == 51)
-        {
-            tile_texture = LoadTexture("assets/tile_51x51.png");
-            flag_texture = LoadTexture("assets/flag_51x51.png");
-            cross_texture = LoadTexture("assets/cross_51x51.png");
-            mine_texture = LoadTexture("assets/mine_51x51.png");
-        }
+    Field::~Field() {}
 
-        for (int row = 0; row < settings.rows; row++)
-        {
-            std::vector<Tile> tile_row;
-            for (int col = 0; col < settings.columns; col++)
-            {
-                Tile tile = Tile(
-                    Vector2{col * settings.tile_size + grid_position.x,
-                            row * settings.tile_size + grid_position.y},
-                    Vector2{(float)row, (float)col},
-                    settings.tile_size, settings.font_size,
-                    &tile_texture,
-                    &flag_texture,
-                    &mine_texture,
-                    &cross_texture);
-
-                tile_row.push_back(tile);
-            }
-            grid.push_back(tile_row);
-        }
+    /**
+     * @brief Draws the field grid and tiles as one batch.
+     *
+     */
+    void Field::Draw()
+    {
+        UpdateViewport();
+        GridLayout layout = Layout();
+        GridRange visible = VisibleRange();
 
-        // Populate mines
-        int num_mines_placed = 0;
+        // Only the visible cells are drawn, the cost depends on the window and not on the board
+        BeginScissorMode(viewport.x, viewport.y, viewport.width, viewport.height);
+        BeginMode2D(camera);
+        renderer.Draw(board, layout, visible);
 
-        while (num_mines_placed < settings.mines)
-        {
-            int row = GetRandomValue(0, settings.rows - 1);
-            int col = GetRandomValue(0, settings.columns - 1);
+        if (show_heatmap && !GameOver() && !WinningConditionMet())
+            DrawHeatmap(visible);
 
-            if (!MineInTile(row, col))
-            {
-                grid.at(row).at(col).SetMine(true);
-                num_mines_placed++;
-            }
-        }
+        if (hint_row >= 0 && board.At(hint_row, hint_col).concealed)
+            DrawRectangleLinesEx(Rectangle{layout.CellX(hint_col), layout.CellY(hint_row), layout.tile_size, layout.tile_size}, 3, GREEN);
 
-        // Assign tile numbers
-        for (int row = 0; row < settings.rows; row++)
+        EndMode2D();
+        EndScissorMode();
+
+        if (MinimapVisible())
         {
-            for (int col = 0; col < settings.columns; col++)
-            {
-                grid.at(row).at(col).SetNumberNeighborMines(GetNeighborMineCount(row, col));
-            }
+            // Only the rows changed since the last frame are uploaded
+            minimap.Update(board);
+            Rectangle view = Rectangle{camera.target.x / layout.tile_size, camera.target.y / layout.tile_size,
+                                       viewport.width / camera.zoom / layout.tile_size, viewport.height / camera.zoom / layout.tile_size};
+            minimap.Draw(MinimapBounds(), view);
         }
     }
 
-    Field::~Field()
+    bool Field::MinimapVisible()
     {
-        UnloadTexture(tile_texture);
-        UnloadTexture(mine_texture);
-        UnloadTexture(flag_texture);
-        UnloadTexture(cross_texture);
+        GridLayout layout = Layout();
+        return show_minimap && (layout.Width() * camera.zoom > viewport.width || layout.Height() * camera.zoom > viewport.height);
     }
 
-    /**
-     * @brief Draws the field grid and tiles.
-     *
-     */
-    void Field::Draw()
+    Rectangle Field::MinimapBounds()
     {
-        // Draw vertical lines
-        for (int i = 0; i <= Columns(); i++)
-        {
-            DrawLineV((Vector2){(float)(settings.tile_size * i) + grid_position.x, grid_position.y},
-                      (Vector2){(float)(settings.tile_size * i) + grid_position.x, (float)settings.tile_size * Rows() + grid_position.y},
-                      LIGHTGRAY);
-        }
+        float scale = (float)MINIMAP_SIZE / std::max(settings.rows, settings.columns);
+        float width = settings.columns * scale;
+        float height = settings.rows * scale;
+        return Rectangle{viewport.x + viewport.width - width - MINIMAP_MARGIN, viewport.y + viewport.height - height - MINIMAP_MARGIN, width, height};
+    }
 
-        // Draw horizontal lines
-        for (int j = 0; j <= Rows(); j++)
-        {
-            DrawLineV((Vector2){grid_position.x, (float)(settings.tile_size * j) + grid_position.y},
-                      (Vector2){(float)settings.tile_size * Columns() + grid_position.x, (float)(settings.tile_size * j) + grid_position.y},
-                      LIGHTGRAY);
-        }
+    bool Field::JumpMinimap(Vector2 point)
+    {
+        Rectangle bounds = MinimapBounds();
+        if (!MinimapVisible() || !CheckCollisionPointRec(point, bounds))
+            return false;
+
+        GridLayout layout = Layout();
+        CenterOn(Vector2{(point.x - bounds.x) / bounds.width * layout.Width(), (point.y - bounds.y) / bounds.height * layout.Height()});
+        return true;
+    }
+
+    void Field::UpdateViewport()
+    {
+        viewport = Rectangle{grid_position.x, grid_position.y, GetScreenWidth() - grid_position.x, GetScreenHeight() - grid_position.y};
+        camera.offset = grid_position;
+
+        GridLayout layout = Layout();
+        float fit_zoom = std::min(viewport.width / layout.Width(), viewport.height / layout.Height());
+        float min_zoom = std::max(std::min(fit_zoom, 1.0f), VIEW_MIN_TILE_PIXELS / layout.tile_size);
+        camera.zoom = std::max(min_zoom, std::min(camera.zoom, VIEW_MAX_ZOOM));
 
-        // Draw tiles, mines and flags
-        for (int row = 0; row < Rows(); row++)
+        auto clamp_axis = [](float target, float size, float visible)
         {
-            for (int col = 0; col < Columns(); col++)
-            {
-                Tile *tile = GetTile(row, col);
-                tile->Draw(game_over);
-            }
-        }
+            if (size <= visible)
+                return (size - visible) / 2.0f;
+            return std::max(0.0f, std::min(target, size - visible));
+        };
+        camera.target.x = clamp_axis(camera.target.x, layout.Width(), viewport.width / camera.zoom);
+        camera.target.y = clamp_axis(camera.target.y, layout.Height(), viewport.height / camera.zoom);
     }
 
-    /**
-     * @brief Return a pointer to a tile based on a given row and column positions.
-     * Returns `NULL` if invalid positions are passed.
-     *
-     * @param row Row index of the tile
-     * @param col Column index of the tile
-     * @return Tile* Tile on the given position or NULL if position is invalid
-     */
-    Tile *Field::GetTile(int row, int col)
+    GridRange Field::VisibleRange()
     {
-        if (!IsTileValid(row, col))
-            return NULL;
-        return &grid.at(row).at(col);
+        return Layout().VisibleRange(camera.target.x, camera.target.y,
+                                     camera.target.x + viewport.width / camera.zoom, camera.target.y + viewport.height / camera.zoom);
     }
 
-    void Field::RevealGrid()
+    void Field::Pan(Vector2 screen_delta)
     {
-        for (auto &row : grid)
-        {
-            for (auto &tile : row)
-            {
-                if (tile.IsMine() || (!tile.IsMine() && tile.Flagged()))
-                    tile.Reveal();
-            }
-        }
+        camera.target.x -= screen_delta.x / camera.zoom;
+        camera.target.y -= screen_delta.y / camera.zoom;
+        UpdateViewport();
     }
 
-    /**
-     * @brief Checks if the winning condition was met.
-     *
-     * @return true Player won the game.
-     * @return false Player did not (yet) win the game.
-     */
-    bool Field::WinningConditionMet()
+    void Field::Zoom(float factor, Vector2 screen_point)
+    {
+        Vector2 world_point = GetScreenToWorld2D(screen_point, camera);
+        camera.zoom *= factor;
+        UpdateViewport();
+        camera.target.x = world_point.x - (screen_point.x - camera.offset.x) / camera.zoom;
+        camera.target.y = world_point.y - (screen_point.y - camera.offset.y) / camera.zoom;
+        UpdateViewport();
+    }
+
+    void Field::ResetView()
+    {
+        camera.target = Vector2{0.0f, 0.0f};
+        camera.zoom = 1.0f;
+        UpdateViewport();
+    }
+
+    void Field::ScrollTo(int row, int col)
     {
-        return (Rows() * Columns()) - tiles_open_count == settings.mines;
+        GridRange visible = VisibleRange();
+        if (row > visible.first_row && row < visible.end_row - 1 && col > visible.first_col && col < visible.end_col - 1)
+            return;
+
+        GridLayout layout = Layout();
+        CenterOn(Vector2{layout.CellX(col) + layout.tile_size / 2.0f, layout.CellY(row) + layout.tile_size / 2.0f});
+    }
+
+    void Field::CenterOn(Vector2 world_point)
+    {
+        camera.target.x = world_point.x - viewport.width / camera.zoom / 2.0f;
+        camera.target.y = world_point.y - viewport.height / camera.zoom / 2.0f;
+        UpdateViewport();
+    }
+
+    bool Field::CellAtScreen(Vector2 point, int *row, int *col)
+    {
+        // Clicks on the minimap move the view, see `JumpMinimap`
+        if (!CheckCollisionPointRec(point, viewport) || (MinimapVisible() && CheckCollisionPointRec(point, MinimapBounds())))
+            return false;
+
+        Vector2 world_point = GetScreenToWorld2D(point, camera);
+        return Layout().CellAt(world_point.x, world_point.y, row, col);
     }
 
     /**
-     * @brief Performs the flood fill algorithm on a certain tile in the grid.
+     * @brief Tints every concealed, unflagged tile from green (certainly safe) to red (certainly a mine),
+     * see `EmitHeatmapQuads`. The probabilities are only recomputed after the board changed.
      *
-     * @param tile Target tile around which the flood fill algorithm will be performed.
      */
-    void Field::FloodFill(Tile *tile)
+    void Field::DrawHeatmap(const GridRange &visible)
     {
-        if (tile == NULL || tile->Flagged() || !tile->Concealed())
-            return;
-        if (tile->GetNumberNeighborMines() > 0)
+        if (probability_dirty)
         {
-            tile->Reveal();
-            tiles_open_count++;
-            return;
+            probability.Update();
+            probability_dirty = false;
         }
 
-        tile->Reveal();
-        tiles_open_count++;
-
-        FloodFill(GetTile(tile->GridPosX() - 1, tile->GridPosY()));     // N
-        FloodFill(GetTile(tile->GridPosX() - 1, tile->GridPosY() + 1)); // NE
-        FloodFill(GetTile(tile->GridPosX(), tile->GridPosY() + 1));     // E
-        FloodFill(GetTile(tile->GridPosX() + 1, tile->GridPosY() + 1)); // SE
-        FloodFill(GetTile(tile->GridPosX() + 1, tile->GridPosY()));     // S
-        FloodFill(GetTile(tile->GridPosX() + 1, tile->GridPosY() - 1)); // SW
-        FloodFill(GetTile(tile->GridPosX(), tile->GridPosY() - 1));     // W
-        FloodFill(GetTile(tile->GridPosX() - 1, tile->GridPosY() - 1)); // NW
+        renderer.DrawHeatmap(board, probability, Layout(), visible);
     }
 
-    /**
-     * @brief Sanity check for a certain position on the grid.
-     *
-     * @param row Row position
-     * @param col Column position
-     * @return true If row and column are valid positions on the grid.
-     * @return false Row and column are not valid position on the grid.
-     */
-    bool Field::IsTileValid(int row, int col)
+    void Field::RevealGrid()
     {
-        return (!(row < 0) && !(row > grid.size() - 1)) && (!(col < 0) && !(col > grid.at(0).size() - 1));
+        board.RevealAll();
     }
 
     /**
-     * @brief Check if there is a mine in the tile on a given position.
+     * @brief Checks if the winning condition was met.
      *
-     * @param row_pos Row position of the target tile.
-     * @param col_pos Column position of the target tile.
-     * @return true There is a mine in the target tile.
-     * @return false There is no mine in the target tile.
+     * @return true Player won the game.
+     * @return false Player did not (yet) win the game.
      */
-    bool Field::MineInTile(int row_pos, int col_pos)
+    bool Field::WinningConditionMet()
     {
-        if (!IsTileValid(row_pos, col_pos))
-            return false;
-        return grid.at(row_pos).at(col_pos).IsMine();
+        return board.Won();
     }
 
     /**
-     * @brief Returns the number of adjacent tiles containing a mine.
+     * @brief Performs the flood fill algorithm on a certain tile in the grid.
      *
-     * @param own_row_pos Row position of the target tile.
-     * @param own_col_pos Column position of the target tile.
-     * @return int Number of adhjacent tiles containing a mine.
+     * @param row Row index of the tile.
+     * @param col Column index of the tile.
      */
-    int Field::GetNeighborMineCount(int own_row_pos, int own_col_pos)
+    void Field::FloodFill(int row, int col)
     {
-        int num_mines = 0;
-        // N
-        if (MineInTile(own_row_pos - 1, own_col_pos))
-            num_mines++;
-
-        // NE
-        if (MineInTile(own_row_pos - 1, own_col_pos + 1))
-            num_mines++;
-
-        // E
-        if (MineInTile(own_row_pos, own_col_pos + 1))
-            num_mines++;
-
-        // SE
-        if (MineInTile(own_row_pos + 1, own_col_pos + 1))
-            num_mines++;
-
-        // S
-        if (MineInTile(own_row_pos + 1, own_col_pos))
-            num_mines++;
-
-        // SW
-        if (MineInTile(own_row_pos + 1, own_col_pos - 1))
-            num_mines++;
-
-        // W
-        if (MineInTile(own_row_pos, own_col_pos - 1))
-            num_mines++;
-
-        // NW
-        if (MineInTile(own_row_pos - 1, own_col_pos - 1))
-            num_mines++;
-
-        return num_mines;
+        board.FloodFill(row, col);
     }
 
     /**
@@ -265,34 +221,14 @@ namespace minis
      */
     void Field::HandleRightMouse(Vector2 *mouse_point, std::function<void()> sound_callback)
     {
-        bool hit = false;
-
-        for (int row = 0; row < Rows(); row++)
-        {
-            for (int col = 0; col < Columns(); col++)
-            {
-                if (CheckCollisionPointRec(*mouse_point, (Rectangle){col * (float)settings.tile_size + grid_position.x,
-                                                                     row * (float)settings.tile_size + grid_position.y,
-                                                                     settings.tile_size, settings.tile_size}))
-                {
-                    Tile *tile = GetTile(row, col);
-                    if (tile->Concealed())
-                    {
-                        if (tile->ToggleFlag())
-                            flag_count++;
-                        else
-                            flag_count--;
-                    }
-
-                    sound_callback();
-                    hit = true;
-                    break;
-                }
-            }
+        int row, col;
+        if (!CellAtScreen(*mouse_point, &row, &col))
+            return;
 
-            if (hit)
-                break;
-        }
+        hint_row = -1;
+        if (board.ToggleFlag(row, col))
+            recorder.Record(frame, ReplayAction::Flag, row, col);
+        sound_callback();
     }
 
     /**
@@ -303,7 +239,7 @@ namespace minis
      */
     bool Field::GameOver()
     {
-        return game_over;
+        return board.Lost();
     }
 
     /**
@@ -324,54 +260,96 @@ namespace minis
      */
     void Field::HandleLeftMouse(Vector2 *mouse_point, std::function<void()> sound_callback)
     {
-        if (WinningConditionMet() || game_over)
+        if (WinningConditionMet() || GameOver())
+            return;
+
+        int row, col;
+        if (!CellAtScreen(*mouse_point, &row, &col))
             return;
 
-        bool hit = false;
+        hint_row = -1;
+        board.SafeFirstClick(row, col, std::random_device{}());
 
-        for (int row = 0; row < Rows(); row++)
+        RevealResult result = board.Reveal(row, col);
+        solver.Observe(board.LastOpened());
+        probability_dirty = true;
+        if (result != RevealResult::Ignored)
         {
-            for (int col = 0; col < Columns(); col++)
+            recorder.Record(frame, ReplayAction::Reveal, row, col);
+            sound_callback();
+        }
+        if (result == RevealResult::Opened && WinningConditionMet())
+            sound_callback();
+    }
+
+    bool Field::ShowHint()
+    {
+        SolverMove move;
+        if (GameOver() || WinningConditionMet() || !solver.NextSafe(&move))
+        {
+            hint_row = -1;
+            return false;
+        }
+
+        hint_row = move.row;
+        hint_col = move.col;
+        ScrollTo(hint_row, hint_col);
+        return true;
+    }
+
+    int Field::Autoplay(int max_moves)
+    {
+        int played = 0;
+        SolverMove move;
+
+        while (played < max_moves && !GameOver() && !WinningConditionMet() && solver.NextMove(&move))
+        {
+            if (move.mine)
+            {
+                board.ToggleFlag(move.row, move.col);
+                recorder.Record(frame, ReplayAction::Flag, move.row, move.col);
+            }
+            else
             {
-                Tile *tile = GetTile(row, col);
-                if (tile->CheckCollision(*mouse_point))
-                {
-                    if (tile->IsMine() && !tile->Flagged())
-                    {
-                        tile->Reveal();
-                        tile->Trigger();
-                        game_over = true;
-                        RevealGrid();
-                        sound_callback();
-                        break;
-                    }
-
-                    if (tile->Concealed() && !tile->Flagged())
-                    {
-                        if (tile->GetNumberNeighborMines() < 1)
-                        {
-                            FloodFill(GetTile(row, col));
-                        }
-                        else
-                        {
-                            tile->Reveal();
-                            tiles_open_count++;
-                        }
-                        sound_callback();
-                    }
-                    if (WinningConditionMet())
-                    {
-                        sound_callback();
-                        RevealGrid();
-                    }
-
-                    hit = true;
-                    break;
-                }
+                board.Reveal(move.row, move.col);
+                recorder.Record(frame, ReplayAction::Reveal, move.row, move.col);
+                solver.Observe(board.LastOpened());
+                probability_dirty = true;
             }
+            played++;
+        }
+
+        if (played > 0)
+            hint_row = -1;
+        return played;
+    }
+
+    void Field::StartPlayback(const Replay &replay)
+    {
+        player = ReplayPlayer(replay, &board);
+        playback_frame = 0;
+        probability_dirty = true;
+    }
 
-            if (hit)
-                break;
+    void Field::AdvancePlayback(int speed)
+    {
+        if (speed > 0)
+        {
+            playback_frame += speed;
+            player.AdvanceTo(playback_frame, player.Moves());
+        }
+        else
+        {
+            player.AdvanceTo(UINT32_MAX, REPLAY_MAX_EVENTS_PER_FRAME);
+            playback_frame = player.Frame();
         }
+        probability_dirty = true;
+    }
+
+    void Field::SeekPlayback(int move)
+    {
+        player.Seek(move);
+        playback_frame = player.Frame();
+        probability_dirty = true;
     }
 }
\ No newline at end of file
@@ -4,7 +4,14 @@
 #include <vector>
 #include <iostream>
 #include <functional>
-#include "tile.h"
+#include "board.h"
+#include "grid_layout.h"
+#include "minimap.h"
+#include "board_renderer.h"
+#include "asset_cache.h"
+#include "solver.h"
+#include "mine_probability.h"
+#include "replay.h"
 #include "settings.h"
 
 namespace minis
@@ -17,8 +24,20 @@ namespace minis
          *
          * @param position Field's screen position
          * @param settings - Game/Field settings
+         * @param assets Provides the tile atlas, has to outlive the field
          */
-        Field(Vector2 position, GameSettings settings);
+        Field(Vector2 position, GameSettings settings, AssetCache *assets);
+
+        /**
+         * @brief Construct a new Field object on top of an existing board, e. g. a board which
+         * can be solved without guessing.
+         *
+         * @param position Field's screen position
+         * @param settings - Game/Field settings, rows, columns and mines have to match the board
+         * @param board Board to play on
+         * @param assets Provides the tile atlas, has to outlive the field
+         */
+        Field(Vector2 position, GameSettings settings, Board board, AssetCache *assets);
 
         /**
          * @brief Destroy the Field object
@@ -31,13 +50,122 @@ namespace minis
          *
          */
         void Draw();
-        Tile *GetTile(int row, int col);
+
+        /**
+         * @brief Returns the number of draw calls the last `Draw` issued.
+         *
+         * @return int Number of draw calls.
+         */
+        inline int DrawCalls()
+        {
+            return renderer.DrawCalls();
+        }
         void RevealGrid();
-        void FloodFill(Tile *tile);
+        void FloodFill(int row, int col);
+
+        /**
+         * @brief Returns the headless board holding the game state.
+         *
+         * @return const Board* Board of this field.
+         */
+        inline const Board *GetBoard()
+        {
+            return &board;
+        }
+
         bool WinningConditionMet();
         bool GameOver();
         void HandleLeftMouse(Vector2 *mouse_point, std::function<void()> sound_callback);
         void HandleRightMouse(Vector2 *mouse_point, std::function<void()> sound_callback);
+
+        /**
+         * @brief Highlights a tile which is certainly safe, if the solver finds one.
+         *
+         * @return true A safe tile is highlighted.
+         * @return false Nothing is certain in the current position.
+         */
+        bool ShowHint();
+
+        /**
+         * @brief Plays moves the solver is certain about (reveal safe tiles, flag mines).
+         *
+         * @param max_moves Upper bound of moves to play.
+         * @return int Number of moves played.
+         */
+        int Autoplay(int max_moves);
+
+        /**
+         * @brief Shows or hides the mine probability of every concealed tile as a color overlay.
+         * Boards too large for exact probabilities (`MineProbability::Supports`) never show it.
+         *
+         */
+        inline void ToggleHeatmap()
+        {
+            show_heatmap = !show_heatmap && MineProbability::Supports(board);
+        }
+
+        /**
+         * @brief Shows or hides the minimap, which is only drawn while the board does not fit
+         * into the view.
+         *
+         */
+        inline void ToggleMinimap()
+        {
+            show_minimap = !show_minimap;
+        }
+
+        /**
+         * @brief Centers the view on the cell under a screen position on the minimap.
+         *
+         * @return true The position lies on the minimap.
+         * @return false The minimap is hidden or the position misses it.
+         */
+        bool JumpMinimap(Vector2 point);
+
+        /**
+         * @brief Sets the frame the recorded actions are stamped with.
+         *
+         * @param frame Frames (at `TARGET_FPS`) since the game started.
+         */
+        inline void SetFrame(uint32_t frame)
+        {
+            this->frame = frame;
+        }
+
+        /**
+         * @brief Returns the replay of the game so far.
+         *
+         * @return Replay Recorded game.
+         */
+        inline Replay GetReplay() const
+        {
+            return recorder.Finish();
+        }
+
+        /**
+         * @brief Starts playing a replay back. The field has to be created from `replay.InitialBoard()`.
+         *
+         * @param replay Replay to play.
+         */
+        void StartPlayback(const Replay &replay);
+
+        /**
+         * @brief Advances the playback.
+         *
+         * @param speed Recorded frames per frame, 0 plays as fast as possible.
+         */
+        void AdvancePlayback(int speed);
+
+        /**
+         * @brief Jumps to the position after a number of recorded moves.
+         *
+         * @param move Number of moves.
+         */
+        void SeekPlayback(int move);
+
+        inline int PlaybackPosition() const { return player.Position(); }
+        inline int PlaybackMoves() const { return player.Moves(); }
+        inline uint32_t PlaybackFrame() const { return playback_frame; }
         Vector2 Position();
 
         inline const GameSettings *GetGameSettings()
@@ -62,7 +190,7 @@ namespace minis
          */
         inline int FlagCount()
         {
-            return flag_count;
+            return board.FlagCount();
         }
 
         /**
@@ -90,31 +218,104 @@ namespace minis
             return settings.tile_size;
         }
 
+        /**
+         * @brief Returns the screen geometry of the field.
+         *
+         * @return GridLayout Position, tile size and dimensions of the field.
+         */
+        inline GridLayout Layout()
+        {
+            return GridLayout{0.0f, 0.0f, (float)settings.tile_size, settings.rows, settings.columns};
+        }
+
+        /**
+         * @brief Moves the view, i. e. while dragging the board.
+         *
+         * @param screen_delta Distance in screen pixels the board follows.
+         */
+        void Pan(Vector2 screen_delta);
+
+        /**
+         * @brief Zooms the view, the point under `screen_point` stays in place.
+         *
+         * @param factor Zoom factor, the zoom stays between the fitting zoom (at most
+         * `VIEW_MIN_TILE_PIXELS` per tile) and `VIEW_MAX_ZOOM`.
+         * @param screen_point Screen position to zoom at.
+         */
+        void Zoom(float factor, Vector2 screen_point);
+
+        /**
+         * @brief Resets the view to zoom 1 and the upper left corner of the board.
+         *
+         */
+        void ResetView();
+
+        /**
+         * @brief Returns the cells inside of the view.
+         *
+         */
+        GridRange VisibleRange();
+
     private:
-        std::vector<std::vector<Tile>> grid;
+        // The cells live in `board`, one byte each; their screen positions come from `Layout()`
         Vector2 grid_position;
-        bool game_over = false;
-        int tiles_open_count = 0;
+        // Maps the board (at the origin of the world) into the viewport, the area of the window
+        // below `grid_position`
+        Camera2D camera;
+        Rectangle viewport;
+
+        GameSettings settings;
+        Board board;
+        Solver solver;
+        MineProbability probability;
+        BoardRenderer renderer;
+        ReplayRecorder recorder;
+        ReplayPlayer player;
+        Minimap minimap;
+        uint32_t frame = 0;
+        uint32_t playback_frame = 0;
+        bool show_heatmap = false;
+        bool show_minimap = true;
+        bool probability_dirty = true;
+        int hint_row = -1;
+        int hint_col = -1;
+
+        void DrawHeatmap(const GridRange &visible);
 
         /**
-         * @brief Checks if the row and column indices are valid (lie within the bound) for this field.
+         * @brief Fits the viewport to the window and keeps the zoom and the view within bounds:
+         * boards smaller than the view are centered, larger ones cannot be scrolled out of it.
          *
-         * @param row Target row index
-         * @param col Target column index
-         * @return true If row and column are within the field bounds
-         * @return false If row or column are not within field bounds
          */
-        bool IsTileValid(int row, int col);
-        bool MineInTile(int row_pos, int col_pos);
-        int GetNeighborMineCount(int own_row_pos, int own_col_pos);
-        GameSettings settings;
+        void UpdateViewport();
 
-        int flag_count = 0;
+        /**
+         * @brief Returns the cell under a screen position.
+         *
+         * @return true The position lies on a cell inside of the viewport.
+         * @return false The position misses the board or the viewport.
+         */
+        bool CellAtScreen(Vector2 point, int *row, int *col);
 
-        Texture2D tile_texture;
-        Texture2D flag_texture;
-        Texture2D mine_texture;
-        Texture2D cross_texture;
+        /**
+         * @brief Scrolls the view to a cell if it is not visible.
+         *
+         */
+        void ScrollTo(int row, int col);
+
+        /**
+         * @brief Centers the view on a point of the board.
+         *
+         */
+        void CenterOn(Vector2 world_point);
+
+        bool MinimapVisible();
+
+        /**
+         * @brief Returns the screen area of the minimap, in the lower right corner of the viewport.
+         *
+         */
+        Rectangle MinimapBounds();
     };
 }
 
@@ -0,0 +1,87 @@
+#include "frame_profiler.h"
+#include <algorithm>
+
+namespace minis
+{
+    FrameProfiler::~FrameProfiler()
+    {
+        StopCsv();
+    }
+
+    void FrameProfiler::BeginFrame()
+    {
+        Clock::time_point now = Clock::now();
+
+        if (started)
+        {
+            std::chrono::duration<float, std::milli> elapsed = now - frame_start;
+            current.frame_ms = elapsed.count();
+            history[next] = current;
+            next = (next + 1) % FRAME_PROFILER_HISTORY;
+            count = std::min(count + 1, FRAME_PROFILER_HISTORY);
+
+            if (csv)
+            {
+                fprintf(csv, "%llu,%.4f", (unsigned long long)current.frame, current.frame_ms);
+                for (float section_ms : current.section_ms)
+                    fprintf(csv, ",%.4f", section_ms);
+                fprintf(csv, ",%d\n", current.draw_calls);
+            }
+        }
+
+        uint64_t frame = current.frame + (started ? 1 : 0);
+        current = FrameSample();
+        current.frame = frame;
+        frame_start = now;
+        started = true;
+    }
+
+    FrameStats FrameProfiler::Stats()
+    {
+        FrameStats stats;
+        if (count == 0)
+            return stats;
+
+        for (int i = 0; i < count; i++)
+        {
+            const FrameSample &sample = Sample(i);
+            sorted[i] = sample.frame_ms;
+            stats.histogram[std::min(FRAME_PROFILER_BUCKETS - 1, (int)(sample.frame_ms / FRAME_PROFILER_BUCKET_MS))]++;
+            for (int section = 0; section < PROFILE_SECTION_COUNT; section++)
+                stats.section_avg_ms[section] += sample.section_ms[section] / count;
+        }
+
+        // Nearest rank percentiles, nth_element keeps this linear in the history size
+        auto percentile = [&](int percent)
+        {
+            int rank = std::min(count - 1, (count * percent + 99) / 100 - 1);
+            std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.begin() + count);
+            return sorted[rank];
+        };
+        stats.p50_ms = percentile(50);
+        stats.p99_ms = percentile(99);
+        stats.max_ms = *std::max_element(sorted.begin(), sorted.begin() + count);
+        return stats;
+    }
+
+    bool FrameProfiler::StartCsv(const std::string &path)
+    {
+        StopCsv();
+        csv = fopen(path.c_str(), "w");
+        if (!csv)
+            return false;
+
+        fprintf(csv, "frame,frame_ms");
+        for (const char *name : profile_section_names)
+            fprintf(csv, ",%s_ms", name);
+        fprintf(csv, ",draw_calls\n");
+        return true;
+    }
+
+    void FrameProfiler::StopCsv()
+    {
+        if (csv)
+            fclose(csv);
+        csv = nullptr;
+    }
+}
@@ -0,0 +1,170 @@
+#ifndef FRAME_PROFILER_H
+#define FRAME_PROFILER_H
+
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <string>
+
+#define FRAME_PROFILER_HISTORY 240
+// Frame time histogram: buckets of 2.5 ms, the last one takes every frame of 30 ms and more
+#define FRAME_PROFILER_BUCKETS 12
+#define FRAME_PROFILER_BUCKET_MS 2.5f
+
+namespace minis
+{
+    /**
+     * @brief Timed parts of a frame, in the order `UpdateDrawFrame` runs them.
+     *
+     */
+    enum ProfileSection
+    {
+        PROFILE_UPDATE = 0,
+        PROFILE_FIELD_DRAW,
+        PROFILE_HEADER_DRAW,
+        PROFILE_END_DRAWING,
+        PROFILE_SECTION_COUNT,
+    };
+
+    const char *const profile_section_names[PROFILE_SECTION_COUNT] = {"update", "field_draw", "header_draw", "end_drawing"};
+
+    /**
+     * @brief Timings of one frame in milliseconds. `frame_ms` is the time between the start of
+     * this frame and the start of the next one and includes the frame limiter.
+     *
+     */
+    struct FrameSample
+    {
+        uint64_t frame = 0;
+        float frame_ms = 0.0f;
+        float section_ms[PROFILE_SECTION_COUNT] = {};
+        int draw_calls = 0;
+    };
+
+    /**
+     * @brief Frame time statistics over the kept history. `histogram[i]` counts the frames from
+     * `i * FRAME_PROFILER_BUCKET_MS` up to the next bucket.
+     *
+     */
+    struct FrameStats
+    {
+        float p50_ms = 0.0f;
+        float p99_ms = 0.0f;
+        float max_ms = 0.0f;
+        float section_avg_ms[PROFILE_SECTION_COUNT] = {};
+        int histogram[FRAME_PROFILER_BUCKETS] = {};
+    };
+
+    /**
+     * @brief Collects per section timings of the last `FRAME_PROFILER_HISTORY` frames in a ring
+     * buffer and optionally streams every frame to a CSV file. Uses the monotonic steady clock and
+     * never allocates after construction.
+     *
+     */
+    class FrameProfiler
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        FrameProfiler() = default;
+        ~FrameProfiler();
+
+        FrameProfiler(const FrameProfiler &) = delete;
+        FrameProfiler &operator=(const FrameProfiler &) = delete;
+
+        /**
+         * @brief Starts a frame and finishes the previous one.
+         *
+         */
+        void BeginFrame();
+
+        /**
+         * @brief Adds the time since `start` to a section of the current frame.
+         *
+         */
+        inline void AddTime(ProfileSection section, Clock::time_point start)
+        {
+            std::chrono::duration<float, std::milli> elapsed = Clock::now() - start;
+            current.section_ms[section] += elapsed.count();
+        }
+
+        inline void SetDrawCalls(int draw_calls) { current.draw_calls = draw_calls; }
+
+        /**
+         * @brief Returns the percentiles and the histogram of the frame time and the average
+         * section times.
+         *
+         */
+        FrameStats Stats();
+
+        /**
+         * @brief Returns a finished frame, 0 is the oldest kept one.
+         *
+         */
+        inline const FrameSample &Sample(int index) const
+        {
+            return history[(next + FRAME_PROFILER_HISTORY - count + index) % FRAME_PROFILER_HISTORY];
+        }
+
+        inline int SampleCount() const { return count; }
+
+        /**
+         * @brief Writes every following frame to a CSV file.
+         *
+         * @param path Path of the CSV file, it is overwritten.
+         * @return true The file is open.
+         * @return false The file could not be opened.
+         */
+        bool StartCsv(const std::string &path);
+
+        void StopCsv();
+
+        inline bool CsvActive() const { return csv != nullptr; }
+
+    private:
+        std::array<FrameSample, FRAME_PROFILER_HISTORY> history;
+        std::array<float, FRAME_PROFILER_HISTORY> sorted;
+        FrameSample current;
+        Clock::time_point frame_start;
+        bool started = false;
+        int next = 0;
+        int count = 0;
+        FILE *csv = nullptr;
+    };
+
+    /**
+     * @brief Adds the lifetime of the object to a section.
+     *
+     */
+    class ProfileScope
+    {
+    public:
+        ProfileScope(FrameProfiler &profiler, ProfileSection section)
+            : profiler(profiler), section(section), start(FrameProfiler::Clock::now())
+        {
+        }
+
+        ~ProfileScope() { profiler.AddTime(section, start); }
+
+    private:
+        FrameProfiler &profiler;
+        ProfileSection section;
+        FrameProfiler::Clock::time_point start;
+    };
+}
+
+// The game is instrumented with these macros, without MINIS_PROFILER they expand to nothing
+#ifdef MINIS_PROFILER
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#define PROFILE_FRAME(profiler) (profiler).BeginFrame()
+#define PROFILE_SCOPE(profiler, section) ::minis::ProfileScope PROFILE_CONCAT(profile_scope_, __LINE__)((profiler), (section))
+#define PROFILE_DRAW_CALLS(profiler, draw_calls) (profiler).SetDrawCalls(draw_calls)
+#else
+#define PROFILE_FRAME(profiler)
+#define PROFILE_SCOPE(profiler, section)
+#define PROFILE_DRAW_CALLS(profiler, draw_calls)
+#endif
+
+#endif
@@ -1,10 +1,53 @@
 #include "game.h"
 #include "defines.h"
+#include <random>
+#include <algorithm>
+#include <ctime>
+#include <filesystem>
 #define RAYGUI_IMPLEMENTATION
 #include "third_party/raygui.h"
 
 namespace minis
 {
+    namespace
+    {
+        /**
+         * @brief Zooms a view (`Field` or `MarathonField`) with the mouse wheel, pans it while the
+         * middle mouse button is held and resets it with Z.
+         *
+         * @param view View to move.
+         * @param arrow_keys Pans with the arrow keys as well.
+         */
+        template <typename View>
+        void MoveView(View *view, bool arrow_keys)
+        {
+            float wheel = GetMouseWheelMove();
+            if (wheel != 0.0f)
+                view->Zoom(1.0f + wheel * VIEW_ZOOM_STEP, GetMousePosition());
+
+            if (IsMouseButtonDown(MOUSE_BUTTON_MIDDLE))
+                view->Pan(GetMouseDelta());
+
+            if (IsKeyPressed(KEY_Z))
+                view->ResetView();
+
+            if (!arrow_keys)
+                return;
+
+            Vector2 pan = Vector2{0.0f, 0.0f};
+            if (IsKeyDown(KEY_LEFT))
+                pan.x += VIEW_PAN_STEP;
+            if (IsKeyDown(KEY_RIGHT))
+                pan.x -= VIEW_PAN_STEP;
+            if (IsKeyDown(KEY_UP))
+                pan.y += VIEW_PAN_STEP;
+            if (IsKeyDown(KEY_DOWN))
+                pan.y -= VIEW_PAN_STEP;
+            if (pan.x != 0.0f || pan.y != 0.0f)
+                view->Pan(pan);
+        }
+    }
+
     /**
      * @brief Creates a Game object according to the game settings.
      *
@@ -12,25 +55,40 @@ namespace minis
      */
     Game::Game(GameSettings settings)
     {
-        field = new Field(Vector2{0.0f, HEADER_HEIGHT}, settings);
+        assets = new AssetCache();
+        input = new InputQueue();
+        click_sound = assets->ClickSound();
+        field = new Field(Vector2{0.0f, HEADER_HEIGHT}, settings, assets);
+        snapshot = new SnapshotWriter(SNAPSHOT_PATH);
         timer_start = std::chrono::steady_clock::now();
+        last_snapshot = timer_start;
 
-        button_position_x = settings.tile_size * field->Columns() / 2 - BUTTON_SIZE / 2;
+        header_width = GetWindowSize(&settings).x;
+        button_position_x = header_width / 2 - BUTTON_SIZE / 2;
         timer = new DigitalDisplay(
-            Rectangle{(float)button_position_x + SQUARE_SIZE + DISPLAY_OFFSET_X, DISPLAY_OFFSET_Y, DISPLAY_WIDTH, BUTTON_SIZE});
+            Rectangle{(float)button_position_x + SQUARE_SIZE + DISPLAY_OFFSET_X, DISPLAY_OFFSET_Y, DISPLAY_WIDTH, BUTTON_SIZE},
+            assets->DigitAtlas(DISPLAY_FONT_SIZE));
         mine_counter = new DigitalDisplay(
-            Rectangle{(float)button_position_x - DISPLAY_WIDTH - DISPLAY_OFFSET_X, DISPLAY_OFFSET_Y, DISPLAY_WIDTH, BUTTON_SIZE});
+            Rectangle{(float)button_position_x - DISPLAY_WIDTH - DISPLAY_OFFSET_X, DISPLAY_OFFSET_Y, DISPLAY_WIDTH, BUTTON_SIZE},
+            assets->DigitAtlas(DISPLAY_FONT_SIZE));
         SetSoundVolume(click_sound, 0.9f);
         GuiSetStyle(DEFAULT, TEXT_SIZE, 18);
+        ResumeSnapshot();
     }
 
     Game::~Game()
     {
-        field->~Field();
+        if (!marathon && state != State::Playback && !field->GameOver() && !field->WinningConditionMet())
+            SaveSnapshot();
+        delete (marathon);
+        delete (field);
+        delete (snapshot);
         delete (timer);
         delete (mine_counter);
-        StopSound(click_sound);
-        UnloadSound(click_sound);
+        delete (board_pool);
+        delete (input);
+        // Unloads the textures and sounds, after the last field using them is gone
+        delete (assets);
         CloseAudioDevice();
     }
 
@@ -40,30 +98,340 @@ namespace minis
      */
     void Game::Update()
     {
+#ifdef MINIS_PROFILER
+        if (IsKeyPressed(KEY_F3))
+            show_profiler = !show_profiler;
+        if (IsKeyPressed(KEY_F4))
+            ToggleProfilerCsv();
+#endif
+
+        // Clicks only go to the field while it is played
+        if (show_info || (state != State::Play && state != State::Marathon))
+            input->Clear();
+
         if (show_info || state == State::ModeSelect)
             return;
 
+        if (state == State::Playback)
+        {
+            timer->Update();
+            mine_counter->Update();
+            UpdateView();
+            UpdatePlayback();
+            return;
+        }
+
+        if (state == State::Marathon)
+        {
+            timer->Update();
+            mine_counter->Update();
+            UpdateView();
+            HandleInputQueue();
+            // Memory follows the area around the view, not the size of the board
+            marathon->EvictHiddenChunks();
+            if (!Finished())
+            {
+                std::chrono::duration<double> elapsed_seconds = std::chrono::steady_clock::now() - timer_start;
+                time_passed = (int)(elapsed_seconds.count()) < 10000 ? (int)(elapsed_seconds.count()) : 9999;
+            }
+            return;
+        }
+
         if (state == State::Play)
         {
             timer->Update();
             mine_counter->Update();
-            mouse_point = GetMousePosition();
+            UpdateView();
+            HandleInputQueue();
+            // Stamped from the clock, frames skipped while idle must not shorten the replay
+            field->SetFrame(FrameAt(std::chrono::steady_clock::now()));
             if (!field->GameOver() && !field->WinningConditionMet())
             {
                 std::chrono::duration<double> elapsed_seconds = std::chrono::steady_clock::now() - timer_start;
                 // Timer stops counting after reaching 10000 seconds
                 time_passed = (int)(elapsed_seconds.count()) < 10000 ? (int)(elapsed_seconds.count()) : 9999;
 
-                if (IsMouseButtonReleased(MOUSE_BUTTON_LEFT))
-                {
-                    field->HandleLeftMouse(&mouse_point, std::bind(&Game::PlayClickSoundCallback, this));
-                }
-                else if (IsMouseButtonReleased(MOUSE_BUTTON_RIGHT))
+                if (IsKeyPressed(KEY_H))
+                    field->ShowHint();
+                if (IsKeyPressed(KEY_A))
+                    autoplay = !autoplay;
+                if (IsKeyPressed(KEY_P))
+                    field->ToggleHeatmap();
+                // Bounded per frame so large boards stay responsive while the solver plays
+                if (autoplay)
+                    field->Autoplay(AUTOPLAY_MOVES_PER_FRAME);
+
+                if (std::chrono::steady_clock::now() - last_snapshot >= std::chrono::seconds(SNAPSHOT_INTERVAL_SECONDS))
+                    SaveSnapshot();
+            }
+            else
+            {
+                if (!replay_saved)
                 {
-                    field->HandleRightMouse(&mouse_point, std::bind(&Game::PlayClickSoundCallback, this));
+                    SaveReplay();
+                    snapshot->Discard();
                 }
+                if (IsKeyPressed(KEY_R))
+                    StartPlayback(last_replay);
+            }
+        }
+    }
+
+    void Game::UpdateView()
+    {
+        if (state == State::Marathon)
+        {
+            MoveView(marathon, true);
+            return;
+        }
+
+        if (IsKeyPressed(KEY_M))
+            field->ToggleMinimap();
+        // Dragging over the minimap keeps moving the view, the release is not a click on the field
+        if (IsMouseButtonDown(MOUSE_BUTTON_LEFT))
+            field->JumpMinimap(GetMousePosition());
+
+        // Left and right seek while playing back
+        MoveView(field, state == State::Play);
+    }
+
+    void Game::HandleInputQueue()
+    {
+        input->Poll();
+
+        InputEvent event;
+        while (input->Pop(&event))
+        {
+            // The rest of the queue is dropped once a click ended the game
+            if (event.action != InputAction::Release || Finished())
+                continue;
+
+            mouse_point = event.position;
+            if (marathon)
+            {
+                if (event.button == MOUSE_BUTTON_LEFT)
+                    marathon->HandleLeftMouse(&mouse_point, std::bind(&Game::PlayClickSoundCallback, this));
+                else if (event.button == MOUSE_BUTTON_RIGHT)
+                    marathon->HandleRightMouse(&mouse_point, std::bind(&Game::PlayClickSoundCallback, this));
+                continue;
+            }
+
+            field->SetFrame(FrameAt(event.time));
+            if (event.button == MOUSE_BUTTON_LEFT)
+                field->HandleLeftMouse(&mouse_point, std::bind(&Game::PlayClickSoundCallback, this));
+            else if (event.button == MOUSE_BUTTON_RIGHT)
+                field->HandleRightMouse(&mouse_point, std::bind(&Game::PlayClickSoundCallback, this));
+        }
+    }
+
+    uint32_t Game::FrameAt(std::chrono::steady_clock::time_point time)
+    {
+        std::chrono::milliseconds elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(time - timer_start);
+        return (uint32_t)std::max<int64_t>(0, elapsed_ms.count() * TARGET_FPS / 1000);
+    }
+
+    void Game::WaitWhileIdle()
+    {
+        if (!idle_rendering || InputActive() || Animating())
+        {
+            redraw_frames = IDLE_REDRAW_FRAMES;
+            return;
+        }
+
+        // A few more frames after any activity, so everything it changed is drawn
+        if (redraw_frames > 0)
+        {
+            redraw_frames--;
+            return;
+        }
+
+        while (!WindowShouldClose())
+        {
+            double tick = SecondsToNextTick();
+            if (tick == 0.0)
+                break;
+
+            if (tick < 0.0)
+            {
+                EnableEventWaiting();
+                PollInputEvents();
+                DisableEventWaiting();
             }
+            else
+            {
+                // One wakeup per second tick, input ends the wait earlier
+                input->WaitEvents(tick);
+            }
+            idle_wakeups++;
+
+            if (InputActive())
+                break;
+        }
+
+        redraw_frames = IDLE_REDRAW_FRAMES;
+    }
+
+    bool Game::Animating()
+    {
+#ifdef MINIS_PROFILER
+        if (show_profiler)
+            return true;
+#endif
+        if (no_guess_waiting >= 0)
+            return true;
+        if (state == State::Playback)
+            return field->PlaybackPosition() < field->PlaybackMoves();
+        return state == State::Play && autoplay && !field->GameOver() && !field->WinningConditionMet();
+    }
+
+    bool Game::InputActive()
+    {
+        Vector2 mouse_delta = GetMouseDelta();
+        if (!input->Empty() || GetKeyPressed() != 0 || mouse_delta.x != 0.0f || mouse_delta.y != 0.0f || GetMouseWheelMove() != 0.0f || IsWindowResized())
+            return true;
+
+        for (int button = MOUSE_BUTTON_LEFT; button <= MOUSE_BUTTON_MIDDLE; button++)
+        {
+            if (IsMouseButtonPressed(button) || IsMouseButtonReleased(button))
+                return true;
+        }
+
+        // Held arrow keys keep panning
+        return IsKeyDown(KEY_LEFT) || IsKeyDown(KEY_RIGHT) || IsKeyDown(KEY_UP) || IsKeyDown(KEY_DOWN);
+    }
+
+    double Game::SecondsToNextTick()
+    {
+        if ((state != State::Play && state != State::Marathon) || show_info || Finished() || time_passed >= 9999)
+            return -1.0;
+
+        std::chrono::duration<double> remaining = timer_start + std::chrono::seconds(time_passed + 1) - std::chrono::steady_clock::now();
+        return std::max(0.0, remaining.count());
+    }
+
+    void Game::SaveReplay()
+    {
+        replay_saved = true;
+        last_replay = field->GetReplay();
+
+        std::error_code error;
+        std::filesystem::create_directories(REPLAY_DIRECTORY, error);
+        std::string path = std::string(REPLAY_DIRECTORY) + "/minisweeper_" + std::to_string(std::time(nullptr)) + ".msr";
+        if (error || !last_replay.Save(path))
+            TraceLog(LOG_WARNING, "Unable to save replay %s", path.c_str());
+    }
+
+    void Game::SaveSnapshot()
+    {
+        last_snapshot = std::chrono::steady_clock::now();
+
+        // Nothing to resume before the first click, the layout is not final yet
+        const Board *board = field->GetBoard();
+        if (board->OpenCount() == 0 && board->FlagCount() == 0)
+            return;
+
+        uint64_t elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(last_snapshot - timer_start).count();
+        if (!snapshot->Save(*board, *field->GetGameSettings(), elapsed_ms))
+            TraceLog(LOG_WARNING, "Unable to save game to %s", SNAPSHOT_PATH);
+    }
+
+    void Game::ResumeSnapshot()
+    {
+        Board board;
+        GameSettings settings;
+        uint64_t elapsed_ms;
+        if (!LoadSnapshot(SNAPSHOT_PATH, &board, &settings, &elapsed_ms) || board.Lost() || board.Won())
+            return;
+
+        delete field;
+        field = new Field(Vector2{0.0f, HEADER_HEIGHT}, settings, std::move(board), assets);
+        timer_start = std::chrono::steady_clock::now() - std::chrono::milliseconds(elapsed_ms);
+        time_passed = std::min<int>(elapsed_ms / 1000, 9999);
+
+        Vector2 win_size = GetWindowSize(&settings);
+        SetWindowSize(win_size.x, win_size.y);
+        RecalculateUI();
+    }
+
+    void Game::StartPlayback(const Replay &replay)
+    {
+        // Presets keep their tile size, other board sizes get the small tiles
+        GameSettings settings = GameSettings{replay.rows, replay.columns, replay.mines, TILE_SIZE_SMALL, FONT_SIZE_SMALL};
+        for (int level = 0; level < DIFFICULTY_LEVEL_COUNT; level++)
+        {
+            GameSettings preset = GetSettings((DifficultyLevel)level);
+            if (preset.rows == replay.rows && preset.columns == replay.columns && preset.mines == replay.mines)
+                settings = preset;
         }
+
+        Field *playback_field = new Field(Vector2{0.0f, HEADER_HEIGHT}, settings, replay.InitialBoard(), assets);
+        playback_field->StartPlayback(replay);
+        delete field;
+        field = playback_field;
+        delete marathon;
+        marathon = nullptr;
+
+        Vector2 win_size = GetWindowSize(&settings);
+        SetWindowSize(win_size.x, win_size.y);
+        RecalculateUI();
+        autoplay = false;
+        playback_speed = 1;
+        state = State::Playback;
+    }
+
+    void Game::UpdatePlayback()
+    {
+        if (IsKeyPressed(KEY_ONE))
+            playback_speed = 1;
+        else if (IsKeyPressed(KEY_TWO))
+            playback_speed = 10;
+        else if (IsKeyPressed(KEY_THREE))
+            playback_speed = 0;
+
+        // Seeking restores the closest keyframe, so it takes the same time for every position
+        if (IsKeyPressed(KEY_LEFT))
+            field->SeekPlayback(field->PlaybackPosition() - 1);
+        else if (IsKeyPressed(KEY_RIGHT))
+            field->SeekPlayback(field->PlaybackPosition() + 1);
+        else if (IsKeyPressed(KEY_HOME))
+            field->SeekPlayback(0);
+        else if (IsKeyPressed(KEY_END))
+            field->SeekPlayback(field->PlaybackMoves());
+        else
+            field->AdvancePlayback(playback_speed);
+
+        time_passed = std::min<int>(field->PlaybackFrame() / TARGET_FPS, 9999);
+    }
+
+    void Game::DrawPlaybackStatus()
+    {
+        const char *status = TextFormat("Replay %d/%d %s", field->PlaybackPosition(), field->PlaybackMoves(),
+                                        playback_speed == 1 ? "1x" : playback_speed == 10 ? "10x" : "max");
+        DrawRectangle(0, GetScreenHeight() - MENU_FONT_SIZE - 10, MeasureText(status, MENU_FONT_SIZE) + 10, MENU_FONT_SIZE + 10, Fade(BLACK, 0.6f));
+        DrawText(status, 5, GetScreenHeight() - MENU_FONT_SIZE - 5, MENU_FONT_SIZE, RAYWHITE);
+    }
+
+    void Game::StartMarathon()
+    {
+        delete marathon;
+        marathon = new MarathonField(Vector2{0.0f, HEADER_HEIGHT}, std::random_device{}(), assets);
+        timer_start = std::chrono::steady_clock::now();
+        time_passed = 0;
+        autoplay = false;
+        RecalculateUI();
+        state = State::Marathon;
+    }
+
+    bool Game::Finished()
+    {
+        if (marathon)
+            return marathon->GameOver() || marathon->WinningConditionMet();
+        return field->GameOver() || field->WinningConditionMet();
+    }
+
+    const GameSettings *Game::CurrentSettings()
+    {
+        return marathon ? marathon->GetGameSettings() : field->GetGameSettings();
     }
 
     /**
@@ -82,17 +450,109 @@ namespace minis
      */
     void Game::Draw()
     {
-        if (state == State::Play)
         {
-            field->Draw();
+            PROFILE_SCOPE(profiler, PROFILE_FIELD_DRAW);
+            if (state == State::Play)
+            {
+                field->Draw();
+                PROFILE_DRAW_CALLS(profiler, field->DrawCalls());
+            }
+            else if (state == State::Playback)
+            {
+                field->Draw();
+                PROFILE_DRAW_CALLS(profiler, field->DrawCalls());
+                DrawPlaybackStatus();
+            }
+            else if (state == State::Marathon)
+            {
+                marathon->Draw();
+                PROFILE_DRAW_CALLS(profiler, marathon->DrawCalls());
+            }
+            else if (state == State::ModeSelect)
+            {
+                DrawMenu();
+            }
+        }
+
+        {
+            PROFILE_SCOPE(profiler, PROFILE_HEADER_DRAW);
+            DrawHeader();
+        }
+
+#ifdef MINIS_PROFILER
+        if (show_profiler)
+            DrawProfilerOverlay();
+#endif
+    }
+
+#ifdef MINIS_PROFILER
+    void Game::DrawProfilerOverlay()
+    {
+        const Color section_colors[PROFILE_SECTION_COUNT] = {SKYBLUE, LIME, GOLD, LIGHTGRAY};
+        FrameStats stats = profiler.Stats();
+        int line_height = PROFILER_FONT_SIZE + 2;
+        int height = line_height * (PROFILE_SECTION_COUNT + 4) + PROFILER_GRAPH_HEIGHT + PROFILER_HISTOGRAM_HEIGHT + 15;
+        int x = 5, y = HEADER_HEIGHT + 5;
+
+        DrawRectangle(x - 5, y - 5, PROFILER_OVERLAY_WIDTH + 10, height, Fade(BLACK, 0.7f));
+        DrawText(TextFormat("frame p50 %.2f  p99 %.2f  max %.2f ms", stats.p50_ms, stats.p99_ms, stats.max_ms), x, y, PROFILER_FONT_SIZE, RAYWHITE);
+        y += line_height;
+        for (int section = 0; section < PROFILE_SECTION_COUNT; section++)
+        {
+            DrawText(TextFormat("%-12s %.3f ms", profile_section_names[section], stats.section_avg_ms[section]), x, y, PROFILER_FONT_SIZE, section_colors[section]);
+            y += line_height;
+        }
+        int draw_calls = profiler.SampleCount() ? profiler.Sample(profiler.SampleCount() - 1).draw_calls : 0;
+        DrawText(TextFormat("draw calls %d%s", draw_calls, profiler.CsvActive() ? "  [csv]" : ""), x, y, PROFILER_FONT_SIZE, RAYWHITE);
+        y += line_height;
+
+        // One column per frame, newest on the right, the sections stacked bottom up
+        int bottom = y + PROFILER_GRAPH_HEIGHT;
+        float pixels_per_ms = PROFILER_GRAPH_HEIGHT / PROFILER_GRAPH_MS;
+        for (int i = 0; i < profiler.SampleCount(); i++)
+        {
+            const FrameSample &sample = profiler.Sample(i);
+            int column = x + PROFILER_OVERLAY_WIDTH - profiler.SampleCount() + i;
+            float top = bottom;
+            for (int section = 0; section < PROFILE_SECTION_COUNT; section++)
+            {
+                float section_height = std::min(sample.section_ms[section] * pixels_per_ms, top - y);
+                DrawRectangle(column, top - section_height, 1, std::max(1.0f, section_height), section_colors[section]);
+                top -= section_height;
+            }
+        }
+        // 60 fps budget
+        int budget_y = bottom - (int)(1000.0f / 60.0f * pixels_per_ms);
+        DrawLine(x, budget_y, x + PROFILER_OVERLAY_WIDTH, budget_y, RED);
+
+        // Frame time histogram over the same frames, buckets past the budget in red
+        int histogram_bottom = bottom + 5 + PROFILER_HISTOGRAM_HEIGHT;
+        int bucket_width = PROFILER_OVERLAY_WIDTH / FRAME_PROFILER_BUCKETS;
+        int highest = *std::max_element(stats.histogram, stats.histogram + FRAME_PROFILER_BUCKETS);
+        for (int bucket = 0; bucket < FRAME_PROFILER_BUCKETS && highest > 0; bucket++)
+        {
+            int bar_height = stats.histogram[bucket] * PROFILER_HISTOGRAM_HEIGHT / highest;
+            Color color = (bucket + 1) * FRAME_PROFILER_BUCKET_MS <= 1000.0f / 60.0f ? LIME : RED;
+            DrawRectangle(x + bucket * bucket_width, histogram_bottom - bar_height, bucket_width - 1, bar_height, color);
         }
-        else if (state == State::ModeSelect)
+        DrawText(TextFormat("0 ms  (%.1f ms buckets)", FRAME_PROFILER_BUCKET_MS), x, histogram_bottom + 2, PROFILER_FONT_SIZE, RAYWHITE);
+        const char *last = TextFormat(">= %.0f ms", FRAME_PROFILER_BUCKETS * FRAME_PROFILER_BUCKET_MS - FRAME_PROFILER_BUCKET_MS);
+        DrawText(last, x + PROFILER_OVERLAY_WIDTH - MeasureText(last, PROFILER_FONT_SIZE), histogram_bottom + 2, PROFILER_FONT_SIZE, RAYWHITE);
+    }
+
+    void Game::ToggleProfilerCsv()
+    {
+        if (profiler.CsvActive())
         {
-            DrawMenu();
+            profiler.StopCsv();
+            return;
         }
 
-        DrawHeader();
+        std::string path = "minisweeper_profile_" + std::to_string(std::time(nullptr)) + ".csv";
+        if (!profiler.StartCsv(path))
+            TraceLog(LOG_WARNING, "Unable to write profile %s", path.c_str());
     }
+#endif
 
     /**
      * @brief Draws the header containing: Game state button, the timer, mine counter, info button and the sound toggle button.
@@ -100,9 +560,6 @@ namespace minis
      */
     void Game::DrawHeader()
     {
-        std::string time_str = std::to_string(time_passed);
-        time_str.insert(0, 4 - time_str.length(), '0');
-
         int icon = GetButtonIcon();
 
         // Draw game state icon
@@ -114,11 +571,13 @@ namespace minis
         }
 
         // Draw timer
-        timer->Draw(&time_str[0]);
-        std::string mine_count = std::to_string(field->MineCount() - field->FlagCount());
+        timer->Draw(time_passed, 4);
 
-        // Draw mine counter
-        mine_counter->Draw(&mine_count[0]);
+        // Draw mine counter, the mines left in a marathon do not fit it, it counts the opened cells instead
+        if (marathon)
+            mine_counter->Draw((int)std::min<int64_t>(marathon->OpenCount(), 9999), 1);
+        else
+            mine_counter->Draw(field->MineCount() - field->FlagCount(), 1);
 
         // Draw Info button
         if (GuiButton(Rectangle{BUTTON_OFFSET_X, BUTTON_OFFSET_Y, BUTTON_SIZE, BUTTON_SIZE}, GuiIconText(ICON_HELP, "")))
@@ -132,7 +591,7 @@ namespace minis
         if (sound_on)
             GuiSetState(STATE_PRESSED);
 
-        if (GuiButton(Rectangle{(float)field->Columns() * field->TileSize() - BUTTON_SIZE - BUTTON_OFFSET_X, BUTTON_OFFSET_Y, BUTTON_SIZE, BUTTON_SIZE}, GuiIconText(ICON_AUDIO, "")))
+        if (GuiButton(Rectangle{(float)header_width - BUTTON_SIZE - BUTTON_OFFSET_X, BUTTON_OFFSET_Y, BUTTON_SIZE, BUTTON_SIZE}, GuiIconText(ICON_AUDIO, "")))
         {
             if (!sound_on)
                 PlaySound(click_sound);
@@ -144,7 +603,7 @@ namespace minis
         // Show info dialog if info button was pressed.
         if (show_info)
         {
-            Vector2 win_size = GetWindowSize(field->GetGameSettings());
+            Vector2 win_size = GetWindowSize(CurrentSettings());
             int result = GuiMessageBox(
                 Rectangle{INFO_DIALOG_OFFSET, HEADER_HEIGHT + INFO_DIALOG_OFFSET, win_size.x - INFO_DIALOG_OFFSET * 2, win_size.y - (INFO_DIALOG_OFFSET * 2) - HEADER_HEIGHT},
                 GuiIconText(ICON_INFO, "Info"),
@@ -165,8 +624,8 @@ namespace minis
      */
     void Game::DrawMenu()
     {
-        int combo_x_pos = ((field->Columns() * field->TileSize()) / 2) - (COMBOBOX_WIDTH / 2);
-        int combo_y_pos = ((field->Rows() * field->TileSize()) / 4) - (COMBOBOX_HEIGHT / 2);
+        int combo_x_pos = (GetScreenWidth() / 2) - (COMBOBOX_WIDTH / 2);
+        int combo_y_pos = ((GetScreenHeight() - HEADER_HEIGHT) / 4) - (COMBOBOX_HEIGHT / 2);
 
         static int combobox_active = 0;
 
@@ -175,29 +634,112 @@ namespace minis
             Rectangle{(float)combo_x_pos, (float)combo_y_pos, (float)COMBOBOX_WIDTH, (float)COMBOBOX_HEIGHT},
             level_txt.c_str(), combobox_active);
 
-        GameSettings settings = GetSettings((DifficultyLevel)combobox_active);
+        bool custom = combobox_active == DIFFICULTY_LEVEL_COUNT;
+        bool marathon_selected = combobox_active == DIFFICULTY_LEVEL_COUNT + 1;
+        float top_text_y_pos = (float)combo_y_pos + COMBOBOX_HEIGHT + HEADER_HEIGHT;
+        GameSettings settings;
+        if (custom)
+        {
+            settings = DrawCustomSize((float)combo_x_pos, top_text_y_pos - CUSTOM_SPINNER_HEIGHT / 2);
+        }
+        else
+        {
+            settings = marathon_selected ? GetMarathonSettings() : GetSettings((DifficultyLevel)combobox_active);
 
-        std::string rowscols_info_txt = "Rows x columns: " + std::to_string(settings.rows) + " x " + std::to_string(settings.columns);
-        std::string mines_info_txt = "Mines: " + std::to_string(settings.mines);
+            // Draw Info about number of rows/columns and the number of mines.
+            DrawText(TextFormat("Rows x columns: %d x %d", settings.rows, settings.columns), (float)combo_x_pos, top_text_y_pos, MENU_FONT_SIZE, GRAY);
+            DrawText(TextFormat("Mines: %d", settings.mines), (float)combo_x_pos, top_text_y_pos + HEADER_HEIGHT, MENU_FONT_SIZE, GRAY);
+        }
 
-        float top_text_y_pos = (float)combo_y_pos + COMBOBOX_HEIGHT + HEADER_HEIGHT;
-        // Draw Info about number of rows/columns and the number of mines.
-        DrawText(rowscols_info_txt.c_str(), (float)combo_x_pos, top_text_y_pos, MENU_FONT_SIZE, GRAY);
-        DrawText(mines_info_txt.c_str(), (float)combo_x_pos, top_text_y_pos + HEADER_HEIGHT, MENU_FONT_SIZE, GRAY);
+        // Draw checkbox for boards which can be solved without guessing.
+        if (!custom && !marathon_selected)
+        {
+            no_guess = GuiCheckBox(
+                Rectangle{(float)combo_x_pos, top_text_y_pos + NO_GUESS_CHECKBOX_OFFSET_Y, NO_GUESS_CHECKBOX_SIZE, NO_GUESS_CHECKBOX_SIZE},
+                "No guessing", no_guess);
+            // The workers start filling the pool while the player still looks at the menu
+            if (no_guess && !board_pool)
+                board_pool = new BoardPool(BOARD_POOL_SIZE, BOARD_POOL_THREADS);
+        }
+
+        // A different choice cancels the game waiting for the pool
+        if (no_guess_waiting >= 0 && (!no_guess || combobox_active != no_guess_waiting))
+            no_guess_waiting = -1;
 
         // Draw Start button.
         int button_y_pos = top_text_y_pos + START_BUTTON_OFFSET_Y;
-        if (GuiButton(Rectangle{(float)combo_x_pos, (float)button_y_pos, (float)COMBOBOX_WIDTH, (float)COMBOBOX_HEIGHT}, "Start") && !show_info)
-        {
-            Vector2 win_size = GetWindowSize(&settings);
-            SetWindowSize(win_size.x, win_size.y);
-            field = new Field(Vector2{0.0f, HEADER_HEIGHT}, settings);
-            timer_start = std::chrono::steady_clock::now();
-            RecalculateUI();
-            state = State::Play;
+        const char *start_text = no_guess_waiting >= 0 ? "Generating..." : "Start";
+        if (GuiButton(Rectangle{(float)combo_x_pos, (float)button_y_pos, (float)COMBOBOX_WIDTH, (float)COMBOBOX_HEIGHT}, start_text) && !show_info)
+        {
             if (sound_on)
                 PlaySound(click_sound);
+
+            if (marathon_selected)
+            {
+                Vector2 win_size = GetWindowSize(&settings);
+                SetWindowSize(win_size.x, win_size.y);
+                StartMarathon();
+                return;
+            }
+
+            // The pool only holds the presets and custom boards may be too large to prove
+            if (no_guess && !custom)
+                no_guess_waiting = combobox_active;
+            else
+                StartGame(settings, nullptr);
+        }
+
+        // No guessing boards only come from the pool, the menu keeps running until one is ready
+        if (no_guess_waiting >= 0)
+        {
+            Board board;
+            if (board_pool->Take((DifficultyLevel)no_guess_waiting, &board))
+            {
+                StartGame(GetSettings((DifficultyLevel)no_guess_waiting), &board);
+                no_guess_waiting = -1;
+            }
+        }
+    }
+
+    void Game::StartGame(const GameSettings &settings, Board *board)
+    {
+        Vector2 win_size = GetWindowSize(&settings);
+        SetWindowSize(win_size.x, win_size.y);
+
+        delete marathon;
+        marathon = nullptr;
+        delete field;
+        if (board)
+            field = new Field(Vector2{0.0f, HEADER_HEIGHT}, settings, std::move(*board), assets);
+        else
+            field = new Field(Vector2{0.0f, HEADER_HEIGHT}, settings, assets);
+
+        timer_start = std::chrono::steady_clock::now();
+        replay_saved = false;
+        snapshot->Discard();
+        RecalculateUI();
+        state = State::Play;
+    }
+
+    GameSettings Game::DrawCustomSize(float x, float y)
+    {
+        const char *labels[3] = {"Rows", "Columns", "Mines"};
+        int *values[3] = {&custom_rows, &custom_columns, &custom_mines};
+        int max_values[3] = {CUSTOM_MAX_SIZE, CUSTOM_MAX_SIZE, custom_rows * custom_columns - 9};
+
+        // The labels are drawn left of the spinners. A click on a value starts or ends typing into it
+        for (int i = 0; i < 3; i++)
+        {
+            Rectangle bounds = Rectangle{x + COMBOBOX_WIDTH / 2, y + i * CUSTOM_SPINNER_SPACING, COMBOBOX_WIDTH / 2, CUSTOM_SPINNER_HEIGHT};
+            int min_value = i < 2 ? CUSTOM_MIN_SIZE : 1;
+            if (GuiSpinner(bounds, labels[i], values[i], min_value, max_values[i], custom_edit == i))
+                custom_edit = custom_edit == i ? -1 : i;
         }
+
+        GameSettings settings = GetCustomSettings(custom_rows, custom_columns, custom_mines);
+        if (custom_edit < 0)
+            custom_mines = settings.mines;
+        return settings;
     }
 
     /**
@@ -207,11 +749,11 @@ namespace minis
      */
     int Game::GetButtonIcon()
     {
-        if (field->GameOver())
+        if (marathon ? marathon->GameOver() : field->GameOver())
         {
             return ICON_DEMON;
         }
-        else if (field->WinningConditionMet())
+        else if (Finished())
         {
             return ICON_STAR;
         }
@@ -225,7 +767,8 @@ namespace minis
      */
     void Game::RecalculateUI()
     {
-        button_position_x = field->TileSize() * field->Columns() / 2 - BUTTON_SIZE / 2;
+        header_width = GetWindowSize(CurrentSettings()).x;
+        button_position_x = header_width / 2 - BUTTON_SIZE / 2;
         timer->SetPosition(Vector2{(float)button_position_x + SQUARE_SIZE + DISPLAY_OFFSET_X, DISPLAY_OFFSET_Y});
         mine_counter->SetPosition(Vector2{(float)button_position_x - DISPLAY_WIDTH - DISPLAY_OFFSET_X, DISPLAY_OFFSET_Y});
     }
@@ -3,12 +3,19 @@
 
 #include <vector>
 #include <chrono>
+#include <algorithm>
 
 #include "raylib.h"
-#include "tile.h"
 #include "field.h"
+#include "marathon_field.h"
+#include "board_pool.h"
+#include "snapshot.h"
+#include "asset_cache.h"
+#include "input_queue.h"
+#include "frame_profiler.h"
 #include "digital_display.h"
 #include "settings.h"
+#include "defines.h"
 
 #define SQUARE_SIZE 31
 
@@ -18,23 +25,90 @@ namespace minis
     {
         Play,
         ModeSelect,
+        Playback,
+        Marathon,
     };
 
+    /**
+     * @brief Calculates the window size according to the amount of rows, columns and the cell size.
+     * It is limited to the monitor once the window exists, larger boards are scrolled.
+     * 
+     * @param settings GameSetting containing the field setup information
+     * @return Vector2 Window width and height based on the field size.
+     */
+    inline Vector2 GetWindowSize(const GameSettings *settings)
+    {
+        // Smaller boards are centered, the window has to fit the menu
+        float width = std::max(settings->tile_size * settings->columns, WINDOW_MIN_WIDTH);
+        float height = std::max(settings->tile_size * settings->rows + HEADER_HEIGHT, WINDOW_MIN_HEIGHT);
+
+        // Larger boards than the monitor are scrolled, see `Field::Pan`
+        int monitor = GetCurrentMonitor();
+        float max_width = GetMonitorWidth(monitor) * WINDOW_SCREEN_FRACTION;
+        float max_height = GetMonitorHeight(monitor) * WINDOW_SCREEN_FRACTION;
+        if (max_width > 0.0f)
+            width = std::min(width, std::max(max_width, (float)WINDOW_MIN_WIDTH));
+        if (max_height > 0.0f)
+            height = std::min(height, std::max(max_height, (float)WINDOW_MIN_HEIGHT));
+        return Vector2{width, height};
+    }
+
     class Game
     {
     private:
         Field *field;
+        // Only set while the current game is a marathon, `field` keeps the last regular game
+        MarathonField *marathon = nullptr;
+        AssetCache *assets;
+        InputQueue *input;
+        // Created the first time "No guessing" is checked, players who never use it get no workers
+        BoardPool *board_pool = nullptr;
+        SnapshotWriter *snapshot;
 
         Vector2 mouse_point = Vector2{0.0f, 0.0f};
         std::chrono::_V2::steady_clock::time_point timer_start;
+        std::chrono::_V2::steady_clock::time_point last_snapshot;
         int time_passed = 0;
         DigitalDisplay *timer;
         DigitalDisplay *mine_counter;
         bool show_info = false;
         int button_position_x;
-        Sound click_sound = LoadSound("assets/click.wav");
+        int header_width;
+        Sound click_sound;
         State state = State::Play;
         bool sound_on = true;
+        bool autoplay = false;
+        bool no_guess = false;
+        // Difficulty level of the no guessing game waiting for the pool, -1 for none
+        int no_guess_waiting = -1;
+        int custom_rows = 50;
+        int custom_columns = 50;
+        int custom_mines = 400;
+        // Spinner of the custom size in text edit mode, -1 for none
+        int custom_edit = -1;
+        bool replay_saved = false;
+        Replay last_replay;
+        int playback_speed = 1;
+        bool idle_rendering = true;
+        int redraw_frames = IDLE_REDRAW_FRAMES;
+        int idle_wakeups = 0;
+#ifdef MINIS_PROFILER
+        FrameProfiler profiler;
+        bool show_profiler = false;
+
+        /**
+         * @brief Draws the frame time percentiles, the average section times and a graph of the
+         * last frames, split into sections.
+         *
+         */
+        void DrawProfilerOverlay();
+
+        /**
+         * @brief Starts or stops writing every frame to a CSV file in the working directory.
+         *
+         */
+        void ToggleProfilerCsv();
+#endif
 
         /**
          * @brief Get the Button Icon object based on the current game state `state`
@@ -61,8 +135,114 @@ namespace minis
          */
         void DrawMenu();
 
+        /**
+         * @brief Draws the spinners of the custom board size below the combobox.
+         *
+         * @param x Left side of the spinners.
+         * @param y Top of the first spinner.
+         * @return GameSettings Settings of the chosen size.
+         */
+        GameSettings DrawCustomSize(float x, float y);
+
+        /**
+         * @brief Replaces the current game with a new one.
+         *
+         * @param settings Settings of the new game.
+         * @param board Board to play, a random board is created on the first click if it is null.
+         */
+        void StartGame(const GameSettings &settings, Board *board);
+
+        /**
+         * @brief Zooms the field with the mouse wheel and pans it while the middle mouse button
+         * is held, with the minimap or, when playing, with the arrow keys.
+         *
+         */
+        void UpdateView();
+
+        /**
+         * @brief Returns true once the current game, regular or marathon, is won or lost.
+         *
+         */
+        bool Finished();
+
+        /**
+         * @brief Returns the settings of the current game, regular or marathon.
+         *
+         */
+        const GameSettings *CurrentSettings();
+
+        /**
+         * @brief Replaces the current game with a new marathon.
+         *
+         */
+        void StartMarathon();
+
         void PlayClickSoundCallback();
 
+        /**
+         * @brief Keeps the replay of the finished game and writes it to `REPLAY_DIRECTORY`.
+         *
+         */
+        void SaveReplay();
+
+        /**
+         * @brief Writes the game in progress to `SNAPSHOT_PATH`, only the pages changed since the
+         * last save are written.
+         *
+         */
+        void SaveSnapshot();
+
+        /**
+         * @brief Continues the game saved at `SNAPSHOT_PATH`, if there is one.
+         *
+         */
+        void ResumeSnapshot();
+
+        /**
+         * @brief Applies every click queued since the last frame in order, each stamped with the
+         * replay frame it happened in.
+         *
+         */
+        void HandleInputQueue();
+
+        /**
+         * @brief Returns the replay frame (at `TARGET_FPS`) of a point in time of the game.
+         *
+         */
+        uint32_t FrameAt(std::chrono::steady_clock::time_point time);
+
+        /**
+         * @brief Returns true if something moves on screen without input: autoplay, a running
+         * playback, a game waiting for the board pool or the profiler overlay.
+         *
+         */
+        bool Animating();
+
+        /**
+         * @brief Returns true if the last polled input events contain anything the UI reacts to.
+         *
+         */
+        bool InputActive();
+
+        /**
+         * @brief Returns the seconds until the timer display changes, or a negative value if the
+         * timer is not running.
+         *
+         */
+        double SecondsToNextTick();
+
+        /**
+         * @brief Handles the playback controls and advances the playback.
+         *
+         */
+        void UpdatePlayback();
+
+        /**
+         * @brief Draws the playback position and speed.
+         *
+         */
+        void DrawPlaybackStatus();
+
     public:
         /**
          * @brief Construct a new Game object
@@ -88,6 +268,46 @@ namespace minis
          *
          */
         void Draw();
+
+        /**
+         * @brief Replaces the current game with the playback of a replay.
+         *
+         * @param replay Replay to play back.
+         */
+        void StartPlayback(const Replay &replay);
+
+        /**
+         * @brief Blocks while the next frame would look like the last one: no input, no change of
+         * the timer and no animation. Waits for events, while the timer runs at most until its
+         * next second. Call it before updating and drawing a frame.
+         *
+         */
+        void WaitWhileIdle();
+
+        /**
+         * @brief Returns how often `WaitWhileIdle` woke up without drawing a frame.
+         *
+         */
+        inline int IdleWakeups() const
+        {
+            return idle_wakeups;
+        }
+
+        /**
+         * @brief Enables or disables skipping frames while idle, on by default.
+         *
+         */
+        inline void SetIdleRendering(bool enabled)
+        {
+            idle_rendering = enabled;
+        }
+
+#ifdef MINIS_PROFILER
+        inline FrameProfiler &Profiler()
+        {
+            return profiler;
+        }
+#endif
     };
 }
 
@@ -0,0 +1,316 @@
+#include "game_server.h"
+#include <algorithm>
+#include <cstring>
+#include <random>
+
+namespace minis
+{
+    namespace
+    {
+        /**
+         * @brief Resizes `response` to a message with `payload_size` bytes of payload and writes
+         * the header.
+         *
+         * @return uint8_t* Start of the payload.
+         */
+        uint8_t *BeginResponse(std::vector<uint8_t> &response, const RequestHeader &request, ServerStatus status, size_t payload_size)
+        {
+            response.resize(SERVER_RESPONSE_HEADER_SIZE + payload_size);
+            WriteResponseHeader(response.data(), request.type, status, request.request_id, payload_size);
+            return response.data() + SERVER_RESPONSE_HEADER_SIZE;
+        }
+
+        ServerGameState GameState(const Board &board)
+        {
+            if (board.Lost())
+                return ServerGameState::Lost;
+            return board.Won() ? ServerGameState::Won : ServerGameState::Playing;
+        }
+    }
+
+    GameServer::GameServer(int threads) : scheduler(threads), large_scheduler(SERVER_LARGE_BOARD_THREADS)
+    {
+    }
+
+    GameServer::~GameServer()
+    {
+    }
+
+    bool GameServer::Submit(const uint8_t *message, size_t size, const std::shared_ptr<ServerConnection> &connection)
+    {
+        Request request;
+        if (!ReadRequestHeader(message, size, &request.header) || request.header.size != size || size > SERVER_MAX_REQUEST_SIZE)
+            return false;
+
+        request.payload_size = size - SERVER_REQUEST_HEADER_SIZE;
+        std::memcpy(request.payload, message + SERVER_REQUEST_HEADER_SIZE, request.payload_size);
+        request.connection = connection;
+
+        std::shared_ptr<HostedGame> game;
+        if (request.header.type == ServerMessage::NewGame)
+        {
+            // Registered right away, the board is built by a worker as the first request of its inbox
+            game = std::make_shared<HostedGame>();
+            game->id = next_game_id++;
+            game->owner = connection.get();
+            game->large = request.payload_size == 16 &&
+                          GetLittleEndian(request.payload, 2) * GetLittleEndian(request.payload + 2, 2) > SERVER_LARGE_BOARD_CELLS;
+            std::lock_guard<std::mutex> lock(games_mutex);
+            games.emplace(game->id, game);
+        }
+        else
+        {
+            std::lock_guard<std::mutex> lock(games_mutex);
+            auto found = games.find(request.header.game_id);
+            if (found != games.end() && found->second->owner == connection.get())
+                game = found->second;
+        }
+
+        if (!game)
+        {
+            uint8_t response[SERVER_RESPONSE_HEADER_SIZE];
+            size_t response_size = WriteResponseHeader(response, request.header.type, ServerStatus::UnknownGame, request.header.request_id, 0);
+            connection->Send(response, response_size);
+            return true;
+        }
+
+        Enqueue(game, std::move(request));
+        return true;
+    }
+
+    void GameServer::CloseGames(const ServerConnection *connection)
+    {
+        std::vector<std::shared_ptr<HostedGame>> owned;
+        {
+            // Out of the map right away, so no later request finds them
+            std::lock_guard<std::mutex> lock(games_mutex);
+            for (auto it = games.begin(); it != games.end();)
+            {
+                if (it->second->owner == connection)
+                {
+                    owned.push_back(it->second);
+                    it = games.erase(it);
+                }
+                else
+                {
+                    it++;
+                }
+            }
+        }
+
+        // The board is only touched by the worker draining the inbox, which frees it in order
+        for (const std::shared_ptr<HostedGame> &game : owned)
+        {
+            Request request;
+            request.header = RequestHeader{SERVER_REQUEST_HEADER_SIZE, ServerMessage::CloseGame, 0, game->id};
+            request.payload_size = 0;
+            Enqueue(game, std::move(request));
+        }
+    }
+
+    ServerStats GameServer::Stats()
+    {
+        std::lock_guard<std::mutex> lock(games_mutex);
+        return ServerStats{(long)games.size(), moves, scheduler.Steals() + large_scheduler.Steals()};
+    }
+
+    void GameServer::Enqueue(const std::shared_ptr<HostedGame> &game, Request &&request)
+    {
+        bool schedule;
+        {
+            std::lock_guard<std::mutex> lock(game->mutex);
+            game->inbox.push_back(std::move(request));
+            schedule = !game->scheduled;
+            game->scheduled = true;
+        }
+
+        if (schedule)
+            SchedulerOf(*game).Submit([this, game]()
+                                      { Drain(game); });
+    }
+
+    /**
+     * @brief Handles the queued requests of a game in order. After `SERVER_DRAIN_BATCH` requests
+     * the game goes back to the scheduler, so one busy game cannot hold up the others.
+     *
+     */
+    void GameServer::Drain(const std::shared_ptr<HostedGame> &game)
+    {
+        thread_local std::vector<uint8_t> response;
+
+        for (int handled = 0;; handled++)
+        {
+            Request request;
+            {
+                std::lock_guard<std::mutex> lock(game->mutex);
+                if (game->inbox.empty())
+                {
+                    game->scheduled = false;
+                    return;
+                }
+                if (handled == SERVER_DRAIN_BATCH)
+                    break;
+                request = std::move(game->inbox.front());
+                game->inbox.pop_front();
+            }
+
+            Handle(*game, request, response);
+            // Requests of `CloseGames` have no one to answer
+            if (request.connection)
+                request.connection->Send(response.data(), response.size());
+        }
+
+        SchedulerOf(*game).Submit([this, game]()
+                                  { Drain(game); });
+    }
+
+    void GameServer::Handle(HostedGame &game, const Request &request, std::vector<uint8_t> &response)
+    {
+        if (game.closed)
+        {
+            BeginResponse(response, request.header, ServerStatus::UnknownGame, 0);
+            return;
+        }
+
+        switch (request.header.type)
+        {
+        case ServerMessage::NewGame:
+            HandleNewGame(game, request, response);
+            break;
+        case ServerMessage::Reveal:
+        case ServerMessage::Flag:
+            HandleMove(game, request, response);
+            break;
+        case ServerMessage::QueryDelta:
+            HandleQueryDelta(game, request, response);
+            break;
+        case ServerMessage::CloseGame:
+            Close(game);
+            BeginResponse(response, request.header, ServerStatus::Ok, 0);
+            break;
+        default:
+            BeginResponse(response, request.header, ServerStatus::BadRequest, 0);
+            break;
+        }
+    }
+
+    void GameServer::HandleNewGame(HostedGame &game, const Request &request, std::vector<uint8_t> &response)
+    {
+        int rows = request.payload_size == 16 ? (int)GetLittleEndian(request.payload, 2) : 0;
+        int columns = (int)GetLittleEndian(request.payload + 2, 2);
+        int64_t mines = (int64_t)GetLittleEndian(request.payload + 4, 4);
+        uint64_t seed = GetLittleEndian(request.payload + 8, 8);
+
+        if (rows < 1 || columns < 1 || rows > SERVER_MAX_BOARD_SIZE || columns > SERVER_MAX_BOARD_SIZE || mines >= (int64_t)rows * columns)
+        {
+            Close(game);
+            BeginResponse(response, request.header, ServerStatus::BadRequest, 0);
+            return;
+        }
+
+        game.board = Board(rows, columns, (int)mines, seed ? seed : std::random_device{}());
+
+        uint8_t *payload = BeginResponse(response, request.header, ServerStatus::Ok, 12);
+        PutLittleEndian(payload, game.id, 4);
+        PutLittleEndian(payload + 4, rows, 2);
+        PutLittleEndian(payload + 6, columns, 2);
+        PutLittleEndian(payload + 8, mines, 4);
+    }
+
+    void GameServer::HandleMove(HostedGame &game, const Request &request, std::vector<uint8_t> &response)
+    {
+        Board &board = game.board;
+        int row = (int)GetLittleEndian(request.payload, 2);
+        int col = (int)GetLittleEndian(request.payload + 2, 2);
+        if (request.payload_size != 4 || !board.IsValid(row, col))
+        {
+            BeginResponse(response, request.header, ServerStatus::BadRequest, 0);
+            return;
+        }
+        moves++;
+
+        if (request.header.type == ServerMessage::Flag)
+        {
+            bool toggled = board.ToggleFlag(row, col);
+            if (toggled)
+                game.changes.push_back(row * board.Columns() + col);
+
+            uint8_t *payload = BeginResponse(response, request.header, ServerStatus::Ok, 6);
+            payload[0] = toggled;
+            payload[1] = board.At(row, col).flagged;
+            PutLittleEndian(payload + 2, game.changes.size(), 4);
+            return;
+        }
+
+        // The first click never hits a mine, the board is regenerated from a seed derived from
+        // the game's seed, so seeded games stay reproducible
+        if (board.OpenCount() == 0 && !board.Lost())
+            board.SafeFirstClick(row, col, board.Seed() + 1);
+
+        bool was_over = board.Lost() || board.Won();
+        RevealResult result = board.Reveal(row, col);
+        const std::vector<int> &opened = board.LastOpened();
+        game.changes.insert(game.changes.end(), opened.begin(), opened.end());
+
+        // The end of the game reveals the mines and flags as well
+        if (!was_over && (board.Lost() || board.Won()))
+        {
+            for (int r = 0; r < board.Rows(); r++)
+            {
+                for (int c = 0; c < board.Columns(); c++)
+                {
+                    const Cell &cell = board.At(r, c);
+                    if (cell.mine || cell.flagged)
+                        game.changes.push_back(r * board.Columns() + c);
+                }
+            }
+        }
+
+        uint8_t *payload = BeginResponse(response, request.header, ServerStatus::Ok, 10);
+        payload[0] = (uint8_t)result;
+        payload[1] = (uint8_t)GameState(board);
+        PutLittleEndian(payload + 2, opened.size(), 4);
+        PutLittleEndian(payload + 6, game.changes.size(), 4);
+    }
+
+    /**
+     * @brief Sends the current state of the cells which changed since `version`, at most
+     * `SERVER_MAX_DELTA_CELLS` per response; the client asks again with the returned version.
+     * A cell may appear more than once.
+     *
+     */
+    void GameServer::HandleQueryDelta(HostedGame &game, const Request &request, std::vector<uint8_t> &response)
+    {
+        uint64_t version = request.payload_size == 4 ? GetLittleEndian(request.payload, 4) : UINT64_MAX;
+        if (version > game.changes.size())
+        {
+            BeginResponse(response, request.header, ServerStatus::BadRequest, 0);
+            return;
+        }
+
+        size_t count = std::min<size_t>(game.changes.size() - version, SERVER_MAX_DELTA_CELLS);
+        uint8_t *payload = BeginResponse(response, request.header, ServerStatus::Ok, 9 + count * 5);
+        payload[0] = (uint8_t)GameState(game.board);
+        PutLittleEndian(payload + 1, version + count, 4);
+        PutLittleEndian(payload + 5, count, 4);
+
+        uint8_t *entry = payload + 9;
+        int columns = game.board.Columns();
+        for (size_t i = version; i < version + count; i++, entry += 5)
+        {
+            uint32_t cell = game.changes[i];
+            PutLittleEndian(entry, cell, 4);
+            entry[4] = ServerCell(game.board.At(cell / columns, cell % columns));
+        }
+    }
+
+    void GameServer::Close(HostedGame &game)
+    {
+        game.closed = true;
+        game.board = Board();
+        game.changes = std::vector<uint32_t>();
+
+        std::lock_guard<std::mutex> lock(games_mutex);
+        games.erase(game.id);
+    }
+}
@@ -0,0 +1,146 @@
+#ifndef GAME_SERVER_H
+#define GAME_SERVER_H
+
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <memory>
+#include <atomic>
+#include <unordered_map>
+#include <cstdint>
+#include "board.h"
+#include "server_protocol.h"
+#include "task_scheduler.h"
+
+#define SERVER_DRAIN_BATCH 32
+// Games with more cells take milliseconds to build and to open, they get workers of their own
+#define SERVER_LARGE_BOARD_CELLS (128 * 128)
+#define SERVER_LARGE_BOARD_THREADS 1
+
+namespace minis
+{
+    /**
+     * @brief Receives the responses of one client. `Send` is called from the worker threads, for
+     * different games at the same time.
+     *
+     */
+    class ServerConnection
+    {
+    public:
+        virtual ~ServerConnection() = default;
+
+        /**
+         * @brief Sends one complete response message.
+         *
+         */
+        virtual void Send(const uint8_t *data, size_t size) = 0;
+    };
+
+    struct ServerStats
+    {
+        long games;
+        long moves;
+        long steals;
+    };
+
+    /**
+     * @brief Hosts many independent boards without a window, driven by the binary protocol of
+     * `server_protocol.h`. The transport is up to the caller (see `server_main.cpp`), it hands in
+     * complete request messages.
+     * Every game has an inbox: its requests are handled in order, one at a time, by whichever
+     * worker of the `TaskScheduler` picks the game up, so games spread over all cores without
+     * locking the boards. Games larger than `SERVER_LARGE_BOARD_CELLS` run on a separate
+     * scheduler, building and opening them does not hold up the small games.
+     *
+     */
+    class GameServer
+    {
+    public:
+        /**
+         * @brief Construct a new GameServer object.
+         *
+         * @param threads Number of worker threads.
+         */
+        explicit GameServer(int threads);
+
+        /**
+         * @brief Answers the requests still queued and stops the workers.
+         *
+         */
+        ~GameServer();
+
+        GameServer(const GameServer &) = delete;
+        GameServer &operator=(const GameServer &) = delete;
+
+        /**
+         * @brief Queues one request message, the response is sent to `connection` later on.
+         * Requests for an unknown game, or a game another connection started, are answered
+         * right away.
+         *
+         * @param message Complete request message.
+         * @param size Size of the message.
+         * @param connection Receives the response.
+         * @return true The message was queued or answered.
+         * @return false The message is malformed, the connection should be closed.
+         */
+        bool Submit(const uint8_t *message, size_t size, const std::shared_ptr<ServerConnection> &connection);
+
+        /**
+         * @brief Closes every game `connection` started, call it once the client disconnected.
+         * The requests still queued for them are answered first.
+         *
+         */
+        void CloseGames(const ServerConnection *connection);
+
+        ServerStats Stats();
+
+    private:
+        struct Request
+        {
+            RequestHeader header;
+            uint8_t payload[SERVER_MAX_REQUEST_SIZE - SERVER_REQUEST_HEADER_SIZE];
+            size_t payload_size;
+            std::shared_ptr<ServerConnection> connection;
+        };
+
+        struct HostedGame
+        {
+            uint32_t id;
+            // Connection which started the game, the only one allowed to play it
+            const ServerConnection *owner;
+            // Runs on `large_scheduler`, decided by the size in the NewGame request
+            bool large = false;
+            std::mutex mutex;
+            std::deque<Request> inbox;
+            bool scheduled = false;
+            // Only touched by the worker draining the inbox
+            bool closed = false;
+            Board board;
+            // Cells in the order they changed, a client which saw `version` changes asks for the rest
+            std::vector<uint32_t> changes;
+        };
+
+        std::mutex games_mutex;
+        std::unordered_map<uint32_t, std::shared_ptr<HostedGame>> games;
+        std::atomic<uint32_t> next_game_id{1};
+        std::atomic<long> moves{0};
+        // Last, so the workers stop before the games go away
+        TaskScheduler scheduler;
+        TaskScheduler large_scheduler;
+
+        inline TaskScheduler &SchedulerOf(const HostedGame &game)
+        {
+            return game.large ? large_scheduler : scheduler;
+        }
+
+        void Enqueue(const std::shared_ptr<HostedGame> &game, Request &&request);
+        void Drain(const std::shared_ptr<HostedGame> &game);
+        void Handle(HostedGame &game, const Request &request, std::vector<uint8_t> &response);
+        void HandleNewGame(HostedGame &game, const Request &request, std::vector<uint8_t> &response);
+        void HandleMove(HostedGame &game, const Request &request, std::vector<uint8_t> &response);
+        void HandleQueryDelta(HostedGame &game, const Request &request, std::vector<uint8_t> &response);
+        void Close(HostedGame &game);
+    };
+}
+
+#endif
@@ -0,0 +1,100 @@
+#ifndef GRID_LAYOUT_H
+#define GRID_LAYOUT_H
+
+namespace minis
+{
+    /**
+     * @brief Rectangle of cells, rows `first_row` to `end_row - 1` and columns `first_col` to
+     * `end_col - 1`.
+     *
+     */
+    struct GridRange
+    {
+        int first_row;
+        int end_row;
+        int first_col;
+        int end_col;
+    };
+
+    /**
+     * @brief Screen geometry of a board: upper left position, tile size and dimensions.
+     * Maps between (row, column) positions and pixel coordinates in constant time.
+     *
+     */
+    struct GridLayout
+    {
+        float x;
+        float y;
+        float tile_size;
+        int rows;
+        int columns;
+
+        /**
+         * @brief Returns the cell containing a point.
+         *
+         * @param point_x Horizontal point coordinate.
+         * @param point_y Vertical point coordinate.
+         * @param row Receives the row index of the cell.
+         * @param col Receives the column index of the cell.
+         * @return true The point lies on the grid, `row` and `col` are set.
+         * @return false The point lies outside of the grid.
+         */
+        inline bool CellAt(float point_x, float point_y, int *row, int *col) const
+        {
+            float grid_col = (point_x - x) / tile_size;
+            float grid_row = (point_y - y) / tile_size;
+
+            if (grid_col < 0.0f || grid_row < 0.0f)
+                return false;
+
+            int c = (int)grid_col;
+            int r = (int)grid_row;
+
+            if (r >= rows || c >= columns)
+                return false;
+
+            *row = r;
+            *col = c;
+            return true;
+        }
+
+        /**
+         * @brief Returns the cells which overlap an area, i. e. the part of the board inside of
+         * the view, so drawing can skip everything else.
+         *
+         * @param left Left border of the area.
+         * @param top Upper border of the area.
+         * @param right Right border of the area.
+         * @param bottom Lower border of the area.
+         * @return GridRange Overlapping cells, empty if the area misses the grid.
+         */
+        inline GridRange VisibleRange(float left, float top, float right, float bottom) const
+        {
+            auto clamp = [](float value, int max)
+            { return value < 0.0f ? 0 : value > max ? max : (int)value; };
+
+            GridRange range;
+            range.first_col = clamp((left - x) / tile_size, columns);
+            range.end_col = clamp((right - x) / tile_size + 1.0f, columns);
+            range.first_row = clamp((top - y) / tile_size, rows);
+            range.end_row = clamp((bottom - y) / tile_size + 1.0f, rows);
+            return range;
+        }
+
+        /**
+         * @brief Returns every cell of the grid.
+         *
+         */
+        inline GridRange All() const
+        {
+            return GridRange{0, rows, 0, columns};
+        }
+
+        inline float CellX(int col) const { return x + col * tile_size; }
+        inline float CellY(int row) const { return y + row * tile_size; }
+        inline float Width() const { return columns * tile_size; }
+        inline float Height() const { return rows * tile_size; }
+    };
+}
+
+#endif
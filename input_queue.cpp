@@ -0,0 +1,132 @@
+#include "input_queue.h"
+
+#if !defined(PLATFORM_WEB)
+// raylib bundles GLFW on desktop, only the few functions used here are declared
+extern "C"
+{
+    typedef struct GLFWwindow GLFWwindow;
+    typedef void (*GLFWmousebuttonfun)(GLFWwindow *window, int button, int action, int mods);
+    typedef void (*GLFWcursorposfun)(GLFWwindow *window, double x, double y);
+    GLFWmousebuttonfun glfwSetMouseButtonCallback(GLFWwindow *window, GLFWmousebuttonfun callback);
+    GLFWcursorposfun glfwSetCursorPosCallback(GLFWwindow *window, GLFWcursorposfun callback);
+    void glfwGetCursorPos(GLFWwindow *window, double *x, double *y);
+    void glfwWaitEventsTimeout(double timeout);
+}
+#define GLFW_RELEASE 0
+#define GLFW_PRESS 1
+#endif
+
+namespace minis
+{
+#if !defined(PLATFORM_WEB)
+    namespace
+    {
+        InputQueue *active_queue = nullptr;
+        GLFWmousebuttonfun raylib_callback = nullptr;
+        GLFWcursorposfun raylib_cursor_callback = nullptr;
+        // Last position GLFW reported, i. e. where the cursor was when the following button event
+        // happened. Asking GLFW in the button callback would give the position at the time of the poll.
+        Vector2 cursor_position = Vector2{0.0f, 0.0f};
+
+        /**
+         * @brief Queues the event and hands it on to raylib. GLFW calls it from the poll on the
+         * main thread, once for every button change.
+         *
+         */
+        void MouseButtonCallback(GLFWwindow *window, int button, int action, int mods)
+        {
+            if (active_queue && (action == GLFW_PRESS || action == GLFW_RELEASE))
+                active_queue->Push(action == GLFW_PRESS ? InputAction::Press : InputAction::Release, button, cursor_position);
+
+            if (raylib_callback)
+                raylib_callback(window, button, action, mods);
+        }
+
+        /**
+         * @brief Keeps the cursor position in the order of the events and hands it on to raylib.
+         *
+         */
+        void CursorPosCallback(GLFWwindow *window, double x, double y)
+        {
+            cursor_position = Vector2{(float)x, (float)y};
+
+            if (raylib_cursor_callback)
+                raylib_cursor_callback(window, x, y);
+        }
+    }
+#endif
+
+    InputQueue::InputQueue()
+    {
+#if !defined(PLATFORM_WEB)
+        GLFWwindow *window = (GLFWwindow *)GetWindowHandle();
+        double x, y;
+        glfwGetCursorPos(window, &x, &y);
+        cursor_position = Vector2{(float)x, (float)y};
+
+        active_queue = this;
+        raylib_callback = glfwSetMouseButtonCallback(window, MouseButtonCallback);
+        raylib_cursor_callback = glfwSetCursorPosCallback(window, CursorPosCallback);
+        callback_installed = true;
+#endif
+    }
+
+    InputQueue::~InputQueue()
+    {
+#if !defined(PLATFORM_WEB)
+        if (callback_installed)
+        {
+            glfwSetMouseButtonCallback((GLFWwindow *)GetWindowHandle(), raylib_callback);
+            glfwSetCursorPosCallback((GLFWwindow *)GetWindowHandle(), raylib_cursor_callback);
+        }
+        active_queue = nullptr;
+        raylib_callback = nullptr;
+        raylib_cursor_callback = nullptr;
+#endif
+    }
+
+    void InputQueue::Poll()
+    {
+        if (callback_installed)
+            return;
+
+        for (int button = MOUSE_BUTTON_LEFT; button <= MOUSE_BUTTON_MIDDLE; button++)
+        {
+            if (IsMouseButtonPressed(button))
+                Push(InputAction::Press, button, GetMousePosition());
+            if (IsMouseButtonReleased(button))
+                Push(InputAction::Release, button, GetMousePosition());
+        }
+    }
+
+    void InputQueue::Push(InputAction action, int button, Vector2 position)
+    {
+        if (tail - head == INPUT_QUEUE_CAPACITY)
+        {
+            dropped++;
+            return;
+        }
+
+        events[tail % INPUT_QUEUE_CAPACITY] = InputEvent{action, button, position, std::chrono::steady_clock::now()};
+        tail++;
+    }
+
+    bool InputQueue::Pop(InputEvent *event)
+    {
+        if (Empty())
+            return false;
+
+        *event = events[head % INPUT_QUEUE_CAPACITY];
+        head++;
+        return true;
+    }
+
+    void InputQueue::WaitEvents(double timeout_seconds)
+    {
+#if !defined(PLATFORM_WEB)
+        glfwWaitEventsTimeout(timeout_seconds);
+#else
+        WaitTime(timeout_seconds);
+#endif
+    }
+}
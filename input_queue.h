@@ -0,0 +1,115 @@
+#ifndef INPUT_QUEUE_H
+#define INPUT_QUEUE_H
+
+#include <array>
+#include <cstddef>
+#include <chrono>
+#include "raylib.h"
+
+#define INPUT_QUEUE_CAPACITY 256
+
+namespace minis
+{
+    enum class InputAction
+    {
+        Press = 0,
+        Release,
+    };
+
+    /**
+     * @brief One mouse button press or release, with the cursor position and the time it happened.
+     *
+     */
+    struct InputEvent
+    {
+        InputAction action;
+        int button;
+        Vector2 position;
+        std::chrono::steady_clock::time_point time;
+    };
+
+    /**
+     * @brief Records every mouse button press and release in order, also several within one frame.
+     * On desktop the queue is fed by GLFW mouse button and cursor position callbacks chained in
+     * front of raylib's own ones, so raylib keeps working unchanged and every button event carries
+     * the cursor position of its moment. Elsewhere (web) it falls back to the once per frame
+     * button state of raylib.
+     *
+     */
+    class InputQueue
+    {
+    public:
+        /**
+         * @brief Construct a new InputQueue object and install the callbacks. Needs the window and
+         * only one queue may exist at a time.
+         *
+         */
+        InputQueue();
+
+        /**
+         * @brief Destroy the InputQueue object and restore raylib's callbacks.
+         *
+         */
+        ~InputQueue();
+
+        InputQueue(const InputQueue &) = delete;
+        InputQueue &operator=(const InputQueue &) = delete;
+
+        /**
+         * @brief Adds the button changes of the last raylib poll if there is no callback, does
+         * nothing otherwise. Call it once per frame before draining the queue.
+         *
+         */
+        void Poll();
+
+        /**
+         * @brief Takes the oldest event.
+         *
+         * @param event Receives the event.
+         * @return true An event was taken.
+         * @return false The queue is empty.
+         */
+        bool Pop(InputEvent *event);
+
+        /**
+         * @brief Drops all queued events, e. g. clicks which were meant for a menu.
+         *
+         */
+        inline void Clear()
+        {
+            head = tail;
+        }
+
+        inline bool Empty() const { return head == tail; }
+
+        /**
+         * @brief Returns the number of events dropped because the queue was full.
+         *
+         */
+        inline int Dropped() const { return dropped; }
+
+        /**
+         * @brief Adds an event stamped with the current time, it is dropped if the queue is full.
+         *
+         */
+        void Push(InputAction action, int button, Vector2 position);
+
+        /**
+         * @brief Blocks until an input event arrives or the timeout passed. The events go through
+         * raylib's callbacks on top of its last poll, so the next frame sees them as if it had
+         * polled them itself. Without GLFW (web) it only sleeps.
+         *
+         * @param timeout_seconds Longest time to wait.
+         */
+        void WaitEvents(double timeout_seconds);
+
+    private:
+        std::array<InputEvent, INPUT_QUEUE_CAPACITY> events;
+        size_t head = 0;
+        size_t tail = 0;
+        int dropped = 0;
+        bool callback_installed = false;
+    };
+}
+
+#endif
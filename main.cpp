@@ -3,10 +3,13 @@
 #include "third_party/raygui.h"
 #include "settings.h"
 #include "vector"
-#include "tile.h"
 #include "game.h"
 #include <iostream>
 #include <string>
+#include <cstring>
+#include <cstdlib>
+#include <ctime>
+#include <chrono>
 
 #if defined(PLATFORM_WEB)
 #include <emscripten/emscripten.h>
@@ -16,7 +19,7 @@ using namespace ::minis;
 
 void UpdateDrawFrame(Game *game);
 
-int main(void)
+int main(int argc, char **argv)
 {
     GameSettings settings = GetSettings(DifficultyLevel::BEGINNER_1);
     Vector2 win_size = GetWindowSize(&settings);
@@ -24,23 +27,63 @@ int main(void)
     InitWindow(win_size.x, win_size.y, "Minisweeper");
     Image window_icon = LoadImage("assets/mine_31x31.png");
     SetWindowIcon(window_icon);
+    UnloadImage(window_icon);
     InitAudioDevice();
 
     Game *game = new Game(settings);
 
+    // minisweeper [--no-idle] [--measure-cpu <seconds>] [<replay>]
+    // --no-idle draws every frame, --measure-cpu prints the CPU usage after that many seconds and
+    // exits, a replay is played back
+    double measure_seconds = 0.0;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--no-idle") == 0)
+        {
+            game->SetIdleRendering(false);
+        }
+        else if (strcmp(argv[i], "--measure-cpu") == 0 && i + 1 < argc)
+        {
+            measure_seconds = atof(argv[++i]);
+        }
+        else
+        {
+            Replay replay;
+            if (Replay::Load(argv[i], &replay))
+                game->StartPlayback(replay);
+            else
+                std::cerr << "Unable to read replay " << argv[i] << std::endl;
+        }
+    }
+
 #if defined(PLATFORM_WEB)
     emscripten_set_main_loop(UpdateDrawFrame, 60, 1);
 #else
-    SetTargetFPS(60);
+    SetTargetFPS(TARGET_FPS);
+
+    std::clock_t cpu_start = std::clock();
+    auto wall_start = std::chrono::steady_clock::now();
+    int frames_drawn = 0;
 
-    // Main game loop
+    // Main game loop, frames are only drawn if something changed
     while (!WindowShouldClose())
     {
+        game->WaitWhileIdle();
         UpdateDrawFrame(game);
+        frames_drawn++;
+
+        std::chrono::duration<double> wall = std::chrono::steady_clock::now() - wall_start;
+        if (measure_seconds > 0.0 && wall.count() >= measure_seconds)
+        {
+            double cpu = (double)(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+            std::cout << "CPU " << cpu * 100.0 / wall.count() << "% over " << wall.count() << " s, "
+                      << frames_drawn << " frames drawn, " << game->IdleWakeups() << " idle wakeups" << std::endl;
+            break;
+        }
     }
 #endif
 
-    game->~Game();
+    delete game;
 
     CloseWindow();
 
@@ -49,12 +92,19 @@ int main(void)
 
 void UpdateDrawFrame(Game *game)
 {
-    game->Update();
+    PROFILE_FRAME(game->Profiler());
+    {
+        PROFILE_SCOPE(game->Profiler(), PROFILE_UPDATE);
+        game->Update();
+    }
 
     BeginDrawing();
 
     ClearBackground(RAYWHITE);
 
     game->Draw();
+
+    // Includes the buffer swap and the wait of the frame limiter
+    PROFILE_SCOPE(game->Profiler(), PROFILE_END_DRAWING);
     EndDrawing();
 }
\ No newline at end of file
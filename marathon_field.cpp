@@ -0,0 +1,126 @@
+#include "marathon_field.h"
+#include <algorithm>
+
+namespace minis
+{
+    MarathonField::MarathonField(Vector2 position, uint64_t seed, AssetCache *assets)
+        : grid_position(position),
+          settings(GetMarathonSettings()),
+          board(MARATHON_CHUNKS, MARATHON_CHUNKS, MARATHON_MINES_PER_CHUNK, seed),
+          renderer(assets->TileAtlas(settings.tile_size, settings.font_size), settings.tile_size)
+    {
+        camera = Camera2D{position, Vector2{0.0f, 0.0f}, 0.0f, 1.0f};
+        viewport = Rectangle{position.x, position.y, 0.0f, 0.0f};
+        ResetView();
+    }
+
+    void MarathonField::UpdateViewport()
+    {
+        viewport = Rectangle{grid_position.x, grid_position.y, GetScreenWidth() - grid_position.x, GetScreenHeight() - grid_position.y};
+        camera.offset = grid_position;
+
+        // The board is always larger than the view, so it only has to cover it
+        GridLayout layout = Layout();
+        camera.zoom = std::max(VIEW_MIN_TILE_PIXELS / layout.tile_size, std::min(camera.zoom, VIEW_MAX_ZOOM));
+        camera.target.x = std::max(0.0f, std::min(camera.target.x, layout.Width() - viewport.width / camera.zoom));
+        camera.target.y = std::max(0.0f, std::min(camera.target.y, layout.Height() - viewport.height / camera.zoom));
+    }
+
+    GridRange MarathonField::VisibleRange()
+    {
+        return Layout().VisibleRange(camera.target.x, camera.target.y,
+                                     camera.target.x + viewport.width / camera.zoom, camera.target.y + viewport.height / camera.zoom);
+    }
+
+    int MarathonField::EvictHiddenChunks()
+    {
+        UpdateViewport();
+        GridRange visible = VisibleRange();
+
+        // Every chunk the view touches stays, plus a margin so small pans do not regenerate chunks
+        int half_extent = std::max(visible.end_row - visible.first_row, visible.end_col - visible.first_col) / 2;
+        int radius = half_extent / ChunkedBoard::CHUNK_SIZE + 1 + MARATHON_CHUNK_MARGIN;
+        return board.EvictFarChunks((visible.first_row + visible.end_row) / 2, (visible.first_col + visible.end_col) / 2, radius);
+    }
+
+    void MarathonField::Draw()
+    {
+        UpdateViewport();
+
+        BeginScissorMode(viewport.x, viewport.y, viewport.width, viewport.height);
+        BeginMode2D(camera);
+        renderer.Draw(board, Layout(), VisibleRange());
+        EndMode2D();
+        EndScissorMode();
+    }
+
+    void MarathonField::Pan(Vector2 screen_delta)
+    {
+        camera.target.x -= screen_delta.x / camera.zoom;
+        camera.target.y -= screen_delta.y / camera.zoom;
+        UpdateViewport();
+    }
+
+    void MarathonField::Zoom(float factor, Vector2 screen_point)
+    {
+        Vector2 world_point = GetScreenToWorld2D(screen_point, camera);
+        camera.zoom *= factor;
+        UpdateViewport();
+        camera.target.x = world_point.x - (screen_point.x - camera.offset.x) / camera.zoom;
+        camera.target.y = world_point.y - (screen_point.y - camera.offset.y) / camera.zoom;
+        UpdateViewport();
+    }
+
+    void MarathonField::ResetView()
+    {
+        camera.zoom = 1.0f;
+        UpdateViewport();
+        GridLayout layout = Layout();
+        camera.target.x = (layout.Width() - viewport.width) / 2.0f;
+        camera.target.y = (layout.Height() - viewport.height) / 2.0f;
+        UpdateViewport();
+    }
+
+    bool MarathonField::CellAtScreen(Vector2 point, int *row, int *col)
+    {
+        if (!CheckCollisionPointRec(point, viewport))
+            return false;
+
+        Vector2 world_point = GetScreenToWorld2D(point, camera);
+        return Layout().CellAt(world_point.x, world_point.y, row, col);
+    }
+
+    /**
+     * @brief Handles a left click event by revealing closed tiles, the first one moves the mines
+     * out of its neighborhood.
+     *
+     * @param mouse_point Mouse position when the left click event occured.
+     * @param sound_callback Callback function which plays the click sound.
+     */
+    void MarathonField::HandleLeftMouse(Vector2 *mouse_point, std::function<void()> sound_callback)
+    {
+        int row, col;
+        if (board.Won() || board.Lost() || !CellAtScreen(*mouse_point, &row, &col))
+            return;
+
+        board.SafeFirstClick(row, col);
+        if (board.Reveal(row, col) != RevealResult::Ignored)
+            sound_callback();
+    }
+
+    /**
+     * @brief Handles a right click event by toggling flags on valid tiles.
+     *
+     * @param mouse_point Mouse position when the right click event occured.
+     * @param sound_callback Callback function which plays the click sound.
+     */
+    void MarathonField::HandleRightMouse(Vector2 *mouse_point, std::function<void()> sound_callback)
+    {
+        int row, col;
+        if (board.Won() || board.Lost() || !CellAtScreen(*mouse_point, &row, &col))
+            return;
+
+        board.ToggleFlag(row, col);
+        sound_callback();
+    }
+}
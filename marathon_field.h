@@ -0,0 +1,130 @@
+#ifndef MARATHON_FIELD_H
+#define MARATHON_FIELD_H
+
+#include <functional>
+#include "raylib.h"
+#include "chunked_board.h"
+#include "grid_layout.h"
+#include "board_renderer.h"
+#include "asset_cache.h"
+#include "settings.h"
+#include "defines.h"
+
+namespace minis
+{
+    /**
+     * @brief Returns the size of the marathon board, `MARATHON_CHUNKS` chunks in both directions
+     * with `MARATHON_MINES_PER_CHUNK` mines each.
+     *
+     * @return GameSettings Rows, columns and mines of the marathon board.
+     */
+    inline GameSettings GetMarathonSettings()
+    {
+        return GameSettings{MARATHON_CHUNKS * ChunkedBoard::CHUNK_SIZE, MARATHON_CHUNKS * ChunkedBoard::CHUNK_SIZE,
+                            MARATHON_CHUNKS * MARATHON_CHUNKS * MARATHON_MINES_PER_CHUNK, TILE_SIZE_SMALL, FONT_SIZE_SMALL};
+    }
+
+    /**
+     * @brief Field of the marathon mode: a `ChunkedBoard` far larger than the window, which is
+     * only created around the view. Like `Field` it maps the board into the area of the window
+     * below its position with a camera, but it has no solver, replay or minimap, which would need
+     * the whole board in memory.
+     *
+     */
+    class MarathonField
+    {
+    public:
+        /**
+         * @brief Construct a new MarathonField object, the view starts in the center of the board.
+         *
+         * @param position Field's screen position
+         * @param seed Seed of the board
+         * @param assets Provides the tile atlas, has to outlive the field
+         */
+        MarathonField(Vector2 position, uint64_t seed, AssetCache *assets);
+
+        MarathonField(const MarathonField &) = delete;
+        MarathonField &operator=(const MarathonField &) = delete;
+
+        /**
+         * @brief Drops the chunks which are far out of view. Call it once per frame.
+         *
+         * @return int Number of chunks dropped.
+         */
+        int EvictHiddenChunks();
+
+        /**
+         * @brief Draws the visible cells, the chunks in view are created on the way.
+         *
+         */
+        void Draw();
+
+        inline int DrawCalls()
+        {
+            return renderer.DrawCalls();
+        }
+
+        void HandleLeftMouse(Vector2 *mouse_point, std::function<void()> sound_callback);
+        void HandleRightMouse(Vector2 *mouse_point, std::function<void()> sound_callback);
+
+        inline bool WinningConditionMet() const { return board.Won(); }
+        inline bool GameOver() const { return board.Lost(); }
+        inline int64_t OpenCount() const { return board.OpenCount(); }
+
+        /**
+         * @brief Returns the size of the board as game settings, see `GetMarathonSettings`.
+         *
+         */
+        inline const GameSettings *GetGameSettings() const
+        {
+            return &settings;
+        }
+
+        /**
+         * @brief Moves the view, i. e. while dragging the board.
+         *
+         * @param screen_delta Distance in screen pixels the board follows.
+         */
+        void Pan(Vector2 screen_delta);
+
+        /**
+         * @brief Zooms the view, the point under `screen_point` stays in place.
+         *
+         * @param factor Zoom factor, the zoom stays between `VIEW_MIN_TILE_PIXELS` per tile
+         * and `VIEW_MAX_ZOOM`.
+         * @param screen_point Screen position to zoom at.
+         */
+        void Zoom(float factor, Vector2 screen_point);
+
+        /**
+         * @brief Resets the view to zoom 1 and the center of the board.
+         *
+         */
+        void ResetView();
+
+    private:
+        Vector2 grid_position;
+        Camera2D camera;
+        Rectangle viewport;
+
+        GameSettings settings;
+        ChunkedBoard board;
+        BoardRenderer renderer;
+
+        inline GridLayout Layout() const
+        {
+            return GridLayout{0.0f, 0.0f, (float)settings.tile_size, settings.rows, settings.columns};
+        }
+
+        /**
+         * @brief Fits the viewport to the window and keeps the zoom and the view within bounds.
+         *
+         */
+        void UpdateViewport();
+
+        GridRange VisibleRange();
+        bool CellAtScreen(Vector2 point, int *row, int *col);
+    };
+}
+
+#endif
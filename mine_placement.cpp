@@ -0,0 +1,83 @@
+#include "mine_placement.h"
+#include <algorithm>
+
+namespace minis
+{
+    void PlaceMines(uint8_t *plane, int cells, int mines, std::vector<int> excluded, Rng &rng)
+    {
+        const uint8_t taken = 1;
+        const uint8_t blocked = 2;
+
+        excluded.erase(std::remove_if(excluded.begin(), excluded.end(),
+                                      [cells](int index)
+                                      { return index < 0 || index >= cells; }),
+                       excluded.end());
+        std::sort(excluded.begin(), excluded.end());
+        excluded.erase(std::unique(excluded.begin(), excluded.end()), excluded.end());
+
+        int candidates = cells - (int)excluded.size();
+        if (mines < 0 || mines > candidates)
+            throw("Unable to place more mines than there are free cells on the board.");
+
+        // Sample the smaller of both sets: the mines, or the free cells on dense boards.
+        bool invert = mines > candidates / 2;
+        int picks = invert ? candidates - mines : mines;
+
+        // Candidates are the indices [0, candidates). Excluded cells inside that range are substituted
+        // by the free cells behind it, so every sample maps to a cell in O(1).
+        for (int index : excluded)
+            plane[index] = blocked;
+
+        std::vector<int> substitutes;
+        for (int index = candidates; index < cells; index++)
+        {
+            if (plane[index] != blocked)
+                substitutes.push_back(index);
+        }
+
+        auto to_cell = [&](int index)
+        {
+            if (plane[index] != blocked)
+                return index;
+            return substitutes[std::lower_bound(excluded.begin(), excluded.end(), index) - excluded.begin()];
+        };
+
+        // Floyd's algorithm: for j in [n - k, n) pick t in [0, j], take j if t was already taken.
+        // The plane itself serves as the set of taken cells.
+        for (int j = candidates - picks; j < candidates; j++)
+        {
+            int cell = to_cell((int)rng.Below((uint32_t)j + 1));
+            if (plane[cell] == taken)
+                cell = to_cell(j);
+            plane[cell] = taken;
+        }
+
+        if (invert)
+        {
+            // The taken cells are the free ones, everything which is neither taken nor blocked is a mine
+            for (int index = 0; index < cells; index++)
+                plane[index] = plane[index] == 0;
+        }
+        else
+        {
+            for (int index : excluded)
+                plane[index] = 0;
+        }
+    }
+
+    std::vector<int> SafeZone(int rows, int columns, int row, int col)
+    {
+        std::vector<int> zone;
+
+        for (int r = row - 1; r <= row + 1; r++)
+        {
+            for (int c = col - 1; c <= col + 1; c++)
+            {
+                if (r >= 0 && r < rows && c >= 0 && c < columns)
+                    zone.push_back(r * columns + c);
+            }
+        }
+
+        return zone;
+    }
+}
@@ -0,0 +1,37 @@
+#ifndef MINE_PLACEMENT_H
+#define MINE_PLACEMENT_H
+
+#include <vector>
+#include <cstdint>
+#include "rng.h"
+
+namespace minis
+{
+    /**
+     * @brief Places exactly `mines` mines on a zeroed byte plane (one byte per cell, row-major)
+     * using Floyd's sampling over flat cell indices. Every iteration places one mine (or, on boards
+     * with more than 50% mines, one free cell), so there are no retries at any mine density and the
+     * cost is bounded by O(min(mines, cells - mines)) samples plus O(cells) for dense boards.
+     *
+     * @param plane One byte per cell, mines are set to 1. Must be zeroed.
+     * @param cells Number of cells in the plane.
+     * @param mines Number of mines to place.
+     * @param excluded Flat indices of cells which must stay free of mines (i. e. a safe first click).
+     * @param rng Random number generator.
+     */
+    void PlaceMines(uint8_t *plane, int cells, int mines, std::vector<int> excluded, Rng &rng);
+
+    /**
+     * @brief Returns the flat indices of a cell and its (valid) neighbors, which can be passed as
+     * exclusion zone to `PlaceMines` to guarantee an opening on the first click.
+     *
+     * @param rows Number of rows of the board.
+     * @param columns Number of columns of the board.
+     * @param row Row index of the center cell.
+     * @param col Column index of the center cell.
+     * @return std::vector<int> Flat indices of the 3x3 zone around the cell.
+     */
+    std::vector<int> SafeZone(int rows, int columns, int row, int col);
+}
+
+#endif
@@ -0,0 +1,506 @@
+#include "mine_probability.h"
+#include <algorithm>
+#include <cmath>
+
+namespace minis
+{
+    namespace
+    {
+        /**
+         * @brief Backtracking over the cell groups of one component. A group holds the cells with
+         * the same set of constraints, they are interchangeable, so only the number of mines in the
+         * group is enumerated and weighted with the number of ways to place them.
+         * Groups are visited in breadth first order over the constraints, so constraints are
+         * completed early and prune the search.
+         *
+         */
+        struct Enumerator
+        {
+            std::vector<int> order;                          // groups in visiting order
+            std::vector<int> group_size;
+            std::vector<std::vector<int>> group_constraints; // constraints of every group
+            std::vector<int> target;                         // mines required by every constraint
+            std::vector<int> assigned;                       // mines assigned so far
+            std::vector<int> unassigned;                     // cells not assigned yet
+            std::vector<int> assignment;                     // mines in every group
+            std::vector<std::vector<double>> binomial;
+            std::vector<double> *counts;
+            std::vector<double> *group_counts;
+            size_t stride = 0;
+            int max_mines = 0;
+            int mines = 0;
+
+            void Recurse(size_t depth, double ways)
+            {
+                if (depth == order.size())
+                {
+                    (*counts)[mines] += ways;
+                    // Expected mines per cell of every group, weighted by the number of configurations
+                    for (size_t group = 0; group < order.size(); group++)
+                    {
+                        if (assignment[group])
+                            (*group_counts)[group * stride + mines] += ways * assignment[group] / group_size[group];
+                    }
+                    return;
+                }
+
+                int group = order[depth];
+                int cells = group_size[group];
+                // Configurations with more mines than the board has can not occur
+                for (int value = 0; value <= cells && mines + value <= max_mines; value++)
+                {
+                    bool feasible = true;
+                    for (int constraint : group_constraints[group])
+                    {
+                        assigned[constraint] += value;
+                        unassigned[constraint] -= cells;
+                        feasible = feasible && assigned[constraint] <= target[constraint] &&
+                                   assigned[constraint] + unassigned[constraint] >= target[constraint];
+                    }
+
+                    if (feasible)
+                    {
+                        assignment[group] = value;
+                        mines += value;
+                        Recurse(depth + 1, ways * binomial[cells][value]);
+                        mines -= value;
+                        assignment[group] = 0;
+                    }
+
+                    for (int constraint : group_constraints[group])
+                    {
+                        assigned[constraint] -= value;
+                        unassigned[constraint] += cells;
+                    }
+                }
+            }
+        };
+
+        std::vector<double> Convolve(const std::vector<double> &a, const std::vector<double> &b, size_t limit)
+        {
+            std::vector<double> result(std::min(a.size() + b.size() - 1, limit), 0.0);
+            for (size_t i = 0; i < a.size() && i < result.size(); i++)
+            {
+                for (size_t j = 0; j < b.size() && i + j < result.size(); j++)
+                    result[i + j] += a[i] * b[j];
+            }
+            return result;
+        }
+
+        double LogBinomial(int n, int k)
+        {
+            return std::lgamma(n + 1.0) - std::lgamma(k + 1.0) - std::lgamma(n - k + 1.0);
+        }
+    }
+
+    MineProbability::MineProbability(const Board &board)
+        : board(board), rows(board.Rows()), columns(board.Columns()),
+          probabilities((size_t)board.Rows() * board.Columns(), 0.0f),
+          approximated((size_t)board.Rows() * board.Columns(), 0)
+    {
+    }
+
+    int MineProbability::Find(int index)
+    {
+        while (parent[index] != index)
+        {
+            parent[index] = parent[parent[index]];
+            index = parent[index];
+        }
+        return index;
+    }
+
+    /**
+     * @brief Enumerates all mine configurations of a component which satisfy its constraints.
+     *
+     * @param cells Flat indices of the component cells, ascending.
+     * @param constraints Flat indices of the revealed numbers constraining the component.
+     * @param max_mines Most mines the component can hold, configurations with more are skipped.
+     * @param result Receives the configuration counts.
+     */
+    void MineProbability::Enumerate(const std::vector<int> &cells, const std::vector<int> &constraints, int max_mines, ComponentResult *result) const
+    {
+        Enumerator enumerator;
+        int size = (int)cells.size();
+        int constraint_count = (int)constraints.size();
+        std::vector<std::vector<int>> cell_constraints(size);
+
+        max_mines = std::min(max_mines, size);
+        enumerator.max_mines = max_mines;
+        enumerator.stride = (size_t)max_mines + 1;
+        enumerator.target.resize(constraint_count);
+        enumerator.assigned.assign(constraint_count, 0);
+        enumerator.unassigned.assign(constraint_count, 0);
+
+        for (int c = 0; c < constraint_count; c++)
+        {
+            int row = constraints[c] / columns;
+            int col = constraints[c] % columns;
+            enumerator.target[c] = board.At(row, col).neighbor_mines;
+
+            for (int d_row = -1; d_row <= 1; d_row++)
+            {
+                for (int d_col = -1; d_col <= 1; d_col++)
+                {
+                    if ((d_row == 0 && d_col == 0) || !board.IsValid(row + d_row, col + d_col) ||
+                        !board.At(row + d_row, col + d_col).concealed)
+                        continue;
+
+                    int local = (int)(std::lower_bound(cells.begin(), cells.end(), constraints[c] + d_row * columns + d_col) - cells.begin());
+                    cell_constraints[local].push_back(c);
+                    enumerator.unassigned[c]++;
+                }
+            }
+        }
+
+        // Cells with the same constraints form a group (constraints are added in the same order for every cell)
+        std::vector<int> &group_of_cell = result->group_of_cell;
+        group_of_cell.assign(size, 0);
+        std::vector<std::vector<int>> constraint_groups(constraint_count);
+        for (int cell = 0; cell < size; cell++)
+        {
+            auto same = std::find(enumerator.group_constraints.begin(), enumerator.group_constraints.end(), cell_constraints[cell]);
+            group_of_cell[cell] = (int)(same - enumerator.group_constraints.begin());
+            if (same == enumerator.group_constraints.end())
+            {
+                enumerator.group_constraints.push_back(cell_constraints[cell]);
+                enumerator.group_size.push_back(0);
+                for (int constraint : cell_constraints[cell])
+                    constraint_groups[constraint].push_back(group_of_cell[cell]);
+            }
+            enumerator.group_size[group_of_cell[cell]]++;
+        }
+
+        int group_count = (int)enumerator.group_size.size();
+        enumerator.assignment.assign(group_count, 0);
+        enumerator.binomial.resize(9);
+        for (int n = 0; n <= 8; n++)
+        {
+            enumerator.binomial[n].assign(n + 1, 1.0);
+            for (int k = 1; k < n; k++)
+                enumerator.binomial[n][k] = enumerator.binomial[n - 1][k - 1] + enumerator.binomial[n - 1][k];
+        }
+
+        // Breadth first over the constraints, so every constraint is completed soon after it is started
+        std::vector<uint8_t> group_seen(group_count, 0);
+        std::vector<uint8_t> constraint_seen(constraint_count, 0);
+        std::vector<int> queue{0};
+        constraint_seen[0] = 1;
+        for (size_t head = 0; head < queue.size(); head++)
+        {
+            for (int group : constraint_groups[queue[head]])
+            {
+                if (group_seen[group])
+                    continue;
+                group_seen[group] = 1;
+                enumerator.order.push_back(group);
+                for (int next : enumerator.group_constraints[group])
+                {
+                    if (!constraint_seen[next])
+                    {
+                        constraint_seen[next] = 1;
+                        queue.push_back(next);
+                    }
+                }
+            }
+        }
+
+        result->size = size;
+        result->counts.assign(enumerator.stride, 0.0);
+        result->group_counts.assign(group_count * enumerator.stride, 0.0);
+        enumerator.counts = &result->counts;
+        enumerator.group_counts = &result->group_counts;
+        enumerator.Recurse(0, 1.0);
+
+        // Scale to keep large components in range, the factor cancels out when combining
+        double scale = *std::max_element(result->counts.begin(), result->counts.end());
+        if (scale <= 0)
+            scale = 1.0;
+        for (double &count : result->counts)
+            count /= scale;
+        for (double &count : result->group_counts)
+            count /= scale;
+    }
+
+    /**
+     * @brief Gives every concealed cell the density of the mines over the concealed cells, all of
+     * them are approximated.
+     *
+     */
+    void MineProbability::FillDensity()
+    {
+        int concealed = 0;
+        for (int index = 0; index < rows * columns; index++)
+            concealed += board.At(index / columns, index % columns).concealed;
+        if (concealed == 0)
+            return;
+
+        float density = std::min(1.0f, (float)board.MineCount() / concealed);
+        for (int index = 0; index < rows * columns; index++)
+        {
+            if (board.At(index / columns, index % columns).concealed)
+            {
+                probabilities[index] = density;
+                approximated[index] = 1;
+                approximated_count++;
+            }
+        }
+    }
+
+    void MineProbability::Update()
+    {
+        generation++;
+        component_count = 0;
+        cache_hits = 0;
+        std::fill(probabilities.begin(), probabilities.end(), 0.0f);
+        if (approximated_count > 0)
+            std::fill(approximated.begin(), approximated.end(), 0);
+        approximated_count = 0;
+
+        if (board.Lost() || board.Won())
+            return;
+        if (!Supports(board))
+        {
+            FillDensity();
+            return;
+        }
+
+        int cells = rows * columns;
+        parent.assign(cells, -1);
+        std::vector<int> constraints;
+        std::vector<int> constraint_cells; // one concealed neighbor of every constraint
+        int concealed = cells - board.OpenCount();
+
+        // Only the revealed cells next to the frontier constrain anything, the bit planes find
+        // them without visiting the rest of the board
+        std::vector<uint64_t> frontier_words = board.Bits().Frontier();
+        for (size_t w = 0; w < frontier_words.size(); w++)
+        {
+            for (uint64_t word = frontier_words[w]; word; word &= word - 1)
+            {
+                int index = (int)(w * 64 + __builtin_ctzll(word));
+                int row = index / columns;
+                int col = index % columns;
+                for (int d_row = -1; d_row <= 1; d_row++)
+                {
+                    for (int d_col = -1; d_col <= 1; d_col++)
+                    {
+                        if ((d_row == 0 && d_col == 0) || !board.IsValid(row + d_row, col + d_col) ||
+                            board.At(row + d_row, col + d_col).concealed)
+                            continue;
+                        constraints.push_back(index + d_row * columns + d_col);
+                    }
+                }
+            }
+        }
+        std::sort(constraints.begin(), constraints.end());
+        constraints.erase(std::unique(constraints.begin(), constraints.end()), constraints.end());
+
+        // Every revealed number joins its concealed neighbors into one component
+        for (int index : constraints)
+        {
+            int row = index / columns;
+            int col = index % columns;
+            int first = -1;
+            int first_cell = -1;
+            for (int d_row = -1; d_row <= 1; d_row++)
+            {
+                for (int d_col = -1; d_col <= 1; d_col++)
+                {
+                    if ((d_row == 0 && d_col == 0) || !board.IsValid(row + d_row, col + d_col) ||
+                        !board.At(row + d_row, col + d_col).concealed)
+                        continue;
+
+                    int neighbor = index + d_row * columns + d_col;
+                    if (parent[neighbor] < 0)
+                        parent[neighbor] = neighbor;
+                    if (first < 0)
+                    {
+                        first = Find(neighbor);
+                        first_cell = neighbor;
+                    }
+                    else
+                        parent[Find(neighbor)] = first;
+                }
+            }
+
+            constraint_cells.push_back(first_cell);
+        }
+
+        // Group cells and constraints by component
+        std::unordered_map<int, int> component_of_root;
+        std::vector<std::vector<int>> component_cells;
+        std::vector<std::vector<int>> component_constraints;
+        int frontier = 0;
+
+        for (int index = 0; index < cells; index++)
+        {
+            if (parent[index] < 0)
+                continue;
+            auto inserted = component_of_root.emplace(Find(index), (int)component_cells.size());
+            if (inserted.second)
+            {
+                component_cells.emplace_back();
+                component_constraints.emplace_back();
+            }
+            component_cells[inserted.first->second].push_back(index);
+            frontier++;
+        }
+
+        for (size_t c = 0; c < constraints.size(); c++)
+            component_constraints[component_of_root[Find(constraint_cells[c])]].push_back(constraints[c]);
+
+        // Enumerating a large component takes exponential time, its cells count as interior instead
+        for (size_t j = component_cells.size(); j-- > 0;)
+        {
+            if (component_cells[j].size() <= MINE_PROBABILITY_MAX_COMPONENT)
+                continue;
+            for (int index : component_cells[j])
+            {
+                parent[index] = -1;
+                approximated[index] = 1;
+            }
+            approximated_count += (int)component_cells[j].size();
+            frontier -= (int)component_cells[j].size();
+            component_cells.erase(component_cells.begin() + j);
+            component_constraints.erase(component_constraints.begin() + j);
+        }
+
+        // Look up or enumerate every component
+        int mines = board.MineCount();
+        component_count = (int)component_cells.size();
+        std::vector<const ComponentResult *> results(component_count);
+        for (int j = 0; j < component_count; j++)
+        {
+            std::vector<int> key(component_cells[j]);
+            key.push_back(-1);
+            for (int constraint : component_constraints[j])
+            {
+                key.push_back(constraint);
+                key.push_back(board.At(constraint / columns, constraint % columns).neighbor_mines);
+            }
+
+            auto found = cache.find(key);
+            if (found == cache.end())
+            {
+                found = cache.emplace(std::move(key), ComponentResult()).first;
+                Enumerate(component_cells[j], component_constraints[j], mines, &found->second);
+            }
+            else
+            {
+                cache_hits++;
+            }
+            found->second.last_used = generation;
+            results[j] = &found->second;
+        }
+
+        // Components which are gone can not come back in the same shape, drop them
+        for (auto entry = cache.begin(); entry != cache.end();)
+        {
+            if (entry->second.last_used != generation)
+                entry = cache.erase(entry);
+            else
+                ++entry;
+        }
+
+        // prefix[j]: configurations of components 0..j-1 by mine count
+        int interior = concealed - frontier;
+        size_t limit = (size_t)mines + 1;
+        std::vector<std::vector<double>> prefix(component_count + 1);
+        prefix[0] = {1.0};
+        for (int j = 0; j < component_count; j++)
+            prefix[j + 1] = Convolve(prefix[j], results[j]->counts, limit);
+        const std::vector<double> &total = prefix[component_count];
+
+        // weight[K]: ways to place the other mines on the interior when the frontier holds K mines,
+        // in log space relative to the largest term to stay in range
+        std::vector<double> weight(total.size(), 0.0);
+        double shift = -INFINITY;
+        for (size_t k = 0; k < total.size(); k++)
+        {
+            int left = mines - (int)k;
+            if (left >= 0 && left <= interior && total[k] > 0)
+                shift = std::max(shift, std::log(total[k]) + LogBinomial(interior, left));
+        }
+        if (shift == -INFINITY)
+            return;
+
+        double normalizer = 0.0;
+        double interior_mines = 0.0;
+        for (size_t k = 0; k < total.size(); k++)
+        {
+            int left = mines - (int)k;
+            if (left < 0 || left > interior)
+                continue;
+            weight[k] = std::exp(LogBinomial(interior, left) - shift);
+            normalizer += total[k] * weight[k];
+            interior_mines += total[k] * weight[k] * left;
+        }
+
+        if (interior > 0)
+        {
+            float interior_probability = (float)(interior_mines / interior / normalizer);
+            for (int index = 0; index < cells; index++)
+            {
+                if (parent[index] < 0 && board.At(index / columns, index % columns).concealed)
+                    probabilities[index] = interior_probability;
+            }
+        }
+
+        // Backwards over the components: after[m] is the weight of all positions of the components
+        // behind j given that the components before them hold m mines, so every component costs
+        // time linear in its size and the mines instead of a convolution of the others
+        std::vector<double> after(weight);
+        std::vector<double> next;
+        std::vector<double> rest;
+        std::vector<double> group_sums;
+        for (int j = component_count; j-- > 0;)
+        {
+            const ComponentResult &result = *results[j];
+            const std::vector<double> &before = prefix[j];
+            size_t stride = result.counts.size();
+
+            // rest[k]: weight of all positions in which this component holds k mines
+            rest.assign(stride, 0.0);
+            for (size_t k = 0; k < stride; k++)
+            {
+                for (size_t m = 0; m < before.size() && m + k < after.size(); m++)
+                    rest[k] += before[m] * after[m + k];
+            }
+
+            size_t groups = result.group_counts.size() / stride;
+            group_sums.assign(groups, 0.0);
+            for (size_t group = 0; group < groups; group++)
+            {
+                for (size_t k = 0; k < stride; k++)
+                    group_sums[group] += result.group_counts[group * stride + k] * rest[k];
+            }
+            for (int cell = 0; cell < result.size; cell++)
+                probabilities[component_cells[j][cell]] = (float)(group_sums[result.group_of_cell[cell]] / normalizer);
+
+            next.assign(before.size(), 0.0);
+            for (size_t m = 0; m < before.size(); m++)
+            {
+                for (size_t k = 0; k < stride && m + k < after.size(); k++)
+                    next[m] += result.counts[k] * after[m + k];
+            }
+            after.swap(next);
+        }
+    }
+
+    int MineProbability::SafestCell() const
+    {
+        int safest = -1;
+        for (int index = 0; index < rows * columns; index++)
+        {
+            const Cell &cell = board.At(index / columns, index % columns);
+            if (!cell.concealed || cell.flagged)
+                continue;
+            // An exact probability beats any approximated one
+            if (safest < 0 || (approximated[safest] && !approximated[index]) ||
+                (approximated[safest] == approximated[index] && probabilities[index] < probabilities[safest]))
+                safest = index;
+        }
+        return safest;
+    }
+}
@@ -0,0 +1,154 @@
+#ifndef MINE_PROBABILITY_H
+#define MINE_PROBABILITY_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include "board.h"
+
+// Components with more cells are not enumerated, their cells count as unconstrained
+#define MINE_PROBABILITY_MAX_COMPONENT 128
+// Larger boards only get the global mine density
+#define MINE_PROBABILITY_MAX_CELLS (256 * 256)
+
+namespace minis
+{
+    /**
+     * @brief Exact probability of every concealed cell to hold a mine, given the revealed numbers
+     * and the total number of mines.
+     * The frontier (concealed cells next to a revealed number) is split into independent connected
+     * components. The mine configurations of every component are enumerated and the components are
+     * combined with the number of ways to place the remaining mines on the unconstrained interior
+     * cells (binomial weights). Component results are cached by their cells and constraints, so
+     * after a move only the components the move touched are enumerated again.
+     * The limits: components above `MINE_PROBABILITY_MAX_COMPONENT` (128) cells are not enumerated,
+     * their cells are treated like interior cells, and boards above `MINE_PROBABILITY_MAX_CELLS`
+     * (256 x 256) only get the global mine density, which keeps the time and memory of an update
+     * bounded. Those cells are marked as `Approximated` and `Exact` turns false; the other cells
+     * are then close, but not exact either, since the skipped constraints shift the mines left for
+     * the interior.
+     * Flags are ignored since the player's flags may be wrong.
+     *
+     */
+    class MineProbability
+    {
+    public:
+        /**
+         * @brief Construct a new MineProbability object for a board. Call `Update()` before reading.
+         *
+         * @param board Board to evaluate, has to outlive this object.
+         */
+        explicit MineProbability(const Board &board);
+
+        /**
+         * @brief Recomputes the probabilities for the current position of the board.
+         *
+         */
+        void Update();
+
+        /**
+         * @brief Returns the probability of a cell to hold a mine, 0 for revealed cells.
+         *
+         */
+        inline float At(int row, int col) const { return probabilities[row * columns + col]; }
+        inline const std::vector<float> &Probabilities() const { return probabilities; }
+
+        /**
+         * @brief Checks if the last update is exact, i. e. no component was over the limits.
+         *
+         */
+        inline bool Exact() const { return approximated_count == 0; }
+
+        /**
+         * @brief Checks if the probability of a cell only is the mine density because its component
+         * or the board was over the limits.
+         *
+         */
+        inline bool Approximated(int index) const { return approximated[index] != 0; }
+
+        /**
+         * @brief Returns the number of cells marked as `Approximated` by the last update.
+         *
+         */
+        inline int ApproximatedCount() const { return approximated_count; }
+
+        /**
+         * @brief Returns the concealed, unflagged cell which is least likely a mine. Approximated
+         * cells are only picked if no exact cell is left.
+         *
+         * @return int Flat index of the cell, -1 if there is none.
+         */
+        int SafestCell() const;
+
+        /**
+         * @brief Returns the number of frontier components of the last update.
+         *
+         */
+        inline int Components() const { return component_count; }
+
+        /**
+         * @brief Returns how many components of the last update were taken from the cache.
+         *
+         */
+        inline int CacheHits() const { return cache_hits; }
+
+        /**
+         * @brief Checks if the board is small enough for exact probabilities.
+         *
+         */
+        static inline bool Supports(const Board &board)
+        {
+            return (long long)board.Rows() * board.Columns() <= MINE_PROBABILITY_MAX_CELLS;
+        }
+
+    private:
+        /**
+         * @brief Configurations of one component, by number of mines in the component.
+         * All entries are scaled by the same factor, which cancels out when combining.
+         *
+         */
+        struct ComponentResult
+        {
+            int size = 0;
+            // counts[k]: configurations with k mines, k up to the mines of the board
+            std::vector<double> counts;
+            // Cells with the same constraints form a group and share their probability
+            std::vector<int> group_of_cell;
+            // group_counts[group * counts.size() + k]: configurations with k mines, weighted by the
+            // mines per cell of the group
+            std::vector<double> group_counts;
+            uint64_t last_used = 0;
+        };
+
+        struct KeyHash
+        {
+            size_t operator()(const std::vector<int> &key) const
+            {
+                uint64_t hash = 1469598103934665603ULL;
+                for (int value : key)
+                    hash = (hash ^ (uint32_t)value) * 1099511628211ULL;
+                return (size_t)hash;
+            }
+        };
+
+        const Board &board;
+        int rows;
+        int columns;
+        std::vector<float> probabilities;
+        std::vector<uint8_t> approximated;
+        int approximated_count = 0;
+        std::unordered_map<std::vector<int>, ComponentResult, KeyHash> cache;
+        uint64_t generation = 0;
+        int component_count = 0;
+        int cache_hits = 0;
+
+        std::vector<int> parent;
+
+        int Find(int index);
+        void Enumerate(const std::vector<int> &cells, const std::vector<int> &constraints, int max_mines, ComponentResult *result) const;
+        void FillDensity();
+    };
+}
+
+#endif
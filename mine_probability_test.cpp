@@ -0,0 +1,138 @@
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include "board.h"
+#include "mine_probability.h"
+#include "rng.h"
+
+using namespace ::minis;
+
+#define MAX_BRUTE_FORCE_CELLS 16
+
+/**
+ * @brief Probability of every cell to hold a mine by trying every mine layout of the concealed
+ * cells which matches the revealed numbers and the mine count.
+ *
+ * @return false There are too many concealed cells to try them all.
+ */
+static bool BruteForce(const Board &board, std::vector<double> *probabilities)
+{
+    int rows = board.Rows();
+    int columns = board.Columns();
+    std::vector<int> concealed;
+    for (int index = 0; index < rows * columns; index++)
+    {
+        if (board.At(index / columns, index % columns).concealed)
+            concealed.push_back(index);
+    }
+    if (concealed.size() > MAX_BRUTE_FORCE_CELLS)
+        return false;
+
+    std::vector<double> mines(rows * columns, 0.0);
+    std::vector<uint8_t> layout(rows * columns);
+    double layouts = 0.0;
+    for (uint32_t subset = 0; subset < (1u << concealed.size()); subset++)
+    {
+        if (__builtin_popcount(subset) != board.MineCount())
+            continue;
+
+        std::fill(layout.begin(), layout.end(), 0);
+        for (size_t bit = 0; bit < concealed.size(); bit++)
+            layout[concealed[bit]] = (subset >> bit) & 1;
+
+        bool matches = true;
+        for (int index = 0; index < rows * columns && matches; index++)
+        {
+            int row = index / columns;
+            int col = index % columns;
+            const Cell &cell = board.At(row, col);
+            if (cell.concealed)
+                continue;
+
+            int count = 0;
+            for (int r = row - 1; r <= row + 1; r++)
+            {
+                for (int c = col - 1; c <= col + 1; c++)
+                    count += board.IsValid(r, c) && layout[r * columns + c];
+            }
+            matches = count == cell.neighbor_mines;
+        }
+
+        if (!matches)
+            continue;
+        layouts++;
+        for (int index : concealed)
+            mines[index] += layout[index];
+    }
+
+    probabilities->assign(rows * columns, 0.0);
+    for (int index : concealed)
+        (*probabilities)[index] = mines[index] / layouts;
+    return true;
+}
+
+/**
+ * @brief Compares `MineProbability` against brute force on small boards with random openings.
+ *
+ */
+int main()
+{
+    int positions = 0;
+    int failed = 0;
+    Rng rng(1);
+
+    for (int game = 0; positions < 400; game++)
+    {
+        int size = 4 + game % 2;
+        int mines = 2 + (int)rng.Below(5);
+        Board board(size, size, mines, rng.Next());
+        MineProbability probability(board);
+
+        while (!board.Lost() && !board.Won())
+        {
+            int row = (int)rng.Below(size);
+            int col = (int)rng.Below(size);
+            if (board.At(row, col).mine || !board.At(row, col).concealed)
+                continue;
+            board.Reveal(row, col);
+            if (board.Won())
+                break;
+
+            std::vector<double> expected;
+            if (!BruteForce(board, &expected))
+                continue;
+
+            probability.Update();
+            positions++;
+            for (int index = 0; index < size * size; index++)
+            {
+                if (std::fabs(probability.Probabilities()[index] - expected[index]) > 1e-4)
+                {
+                    printf("%d x %d, %d mines, seed %llu: cell %d is %.5f, brute force %.5f\n", size, size, mines,
+                           (unsigned long long)board.Seed(), index, probability.Probabilities()[index], expected[index]);
+                    failed++;
+                    break;
+                }
+            }
+        }
+    }
+
+    // One row of numbers over a row of 300 concealed cells, a component over the limit
+    int columns = 300;
+    std::vector<uint64_t> mine_words((2 * columns + 63) / 64, 0);
+    for (int col = 1; col < columns; col += 3)
+        mine_words[(columns + col) / 64] |= 1ULL << ((columns + col) % 64);
+    Board strip(2, columns, mine_words);
+    for (int col = 0; col < columns; col++)
+        strip.Reveal(0, col);
+    MineProbability probability(strip);
+    probability.Update();
+    if (probability.Exact() || probability.ApproximatedCount() != columns || !probability.Approximated(columns) || probability.Approximated(0))
+    {
+        printf("a component of %d cells is not marked as approximated\n", columns);
+        failed++;
+    }
+
+    printf("%d positions, %d differ from brute force\n", positions, failed);
+    return failed > 0 ? 1 : 0;
+}
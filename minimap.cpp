@@ -0,0 +1,37 @@
+#include "minimap.h"
+
+namespace minis
+{
+    Minimap::Minimap(const Board &board) : image(board)
+    {
+        Image pixels = Image{(void *)image.Row(0), image.Columns(), image.Rows(), 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8};
+        texture = LoadTextureFromImage(pixels);
+        image.ClearDirty();
+    }
+
+    Minimap::~Minimap()
+    {
+        UnloadTexture(texture);
+    }
+
+    void Minimap::Update(const Board &board)
+    {
+        if (!image.Update(board))
+            return;
+
+        // The dirty rows are contiguous in the image, so they go up in one piece
+        int first_row = image.DirtyFirstRow();
+        Rectangle rows = Rectangle{0.0f, (float)first_row, (float)image.Columns(), (float)(image.DirtyEndRow() - first_row)};
+        UpdateTextureRec(texture, rows, image.Row(first_row));
+        image.ClearDirty();
+        uploads++;
+    }
+
+    void Minimap::Draw(Rectangle bounds, Rectangle view)
+    {
+        float scale = bounds.width / image.Columns();
+        DrawRectangleRec(Rectangle{bounds.x - 2, bounds.y - 2, bounds.width + 4, bounds.height + 4}, Fade(BLACK, 0.6f));
+        DrawTexturePro(texture, Rectangle{0.0f, 0.0f, (float)image.Columns(), (float)image.Rows()}, bounds, Vector2{0.0f, 0.0f}, 0.0f, WHITE);
+        DrawRectangleLinesEx(Rectangle{bounds.x + view.x * scale, bounds.y + view.y * scale, view.width * scale, view.height * scale}, 1, GREEN);
+    }
+}
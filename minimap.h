@@ -0,0 +1,61 @@
+#ifndef MINIMAP_H
+#define MINIMAP_H
+
+#include "raylib.h"
+#include "board.h"
+#include "minimap_image.h"
+
+namespace minis
+{
+    /**
+     * @brief Overview of a board next to the `Field` view, one texel per cell. The texture is only
+     * touched for the rows `MinimapImage` marked dirty, in one `UpdateTextureRec` per frame.
+     *
+     */
+    class Minimap
+    {
+    public:
+        /**
+         * @brief Construct a new Minimap object and upload the whole board. Needs the window.
+         *
+         */
+        explicit Minimap(const Board &board);
+
+        /**
+         * @brief Destroy the Minimap object and unload the texture.
+         *
+         */
+        ~Minimap();
+
+        Minimap(const Minimap &) = delete;
+        Minimap &operator=(const Minimap &) = delete;
+
+        /**
+         * @brief Uploads the rows which changed since the last call.
+         *
+         * @param board Board the minimap was created for.
+         */
+        void Update(const Board &board);
+
+        /**
+         * @brief Draws the board scaled into `bounds` and outlines the part shown by the field.
+         *
+         * @param bounds Screen area of the minimap.
+         * @param view Part of the board shown by the field, in cells.
+         */
+        void Draw(Rectangle bounds, Rectangle view);
+
+        /**
+         * @brief Returns the number of texture uploads so far, the first one included.
+         *
+         */
+        inline int Uploads() const { return uploads; }
+
+    private:
+        MinimapImage image;
+        Texture2D texture;
+        int uploads = 1;
+    };
+}
+
+#endif
@@ -0,0 +1,90 @@
+#include "minimap_image.h"
+#include "cell_sprite.h"
+#include <algorithm>
+
+namespace minis
+{
+    MinimapImage::MinimapImage(const Board &board)
+    {
+        Rebuild(board);
+    }
+
+    MinimapPixel MinimapImage::CellColor(const Cell &cell, bool game_over)
+    {
+        switch (CellSprite(cell, game_over))
+        {
+        case SPRITE_CONCEALED:
+            return MinimapPixel{130, 130, 130, 255};
+        case SPRITE_FLAG:
+            return MinimapPixel{255, 161, 0, 255};
+        case SPRITE_OPEN:
+            return MinimapPixel{245, 245, 245, 255};
+        case SPRITE_MINE:
+            return MinimapPixel{40, 40, 40, 255};
+        case SPRITE_MINE_TRIGGERED:
+            return MinimapPixel{230, 41, 55, 255};
+        case SPRITE_WRONG_FLAG:
+            return MinimapPixel{200, 122, 255, 255};
+        default:
+            // Numbers, a little darker than open cells so the fronts stand out
+            return MinimapPixel{200, 200, 200, 255};
+        }
+    }
+
+    void MinimapImage::Rebuild(const Board &board)
+    {
+        rows = board.Rows();
+        columns = board.Columns();
+        lost = board.Lost();
+        revealed = board.Bits().Words(BitBoard::REVEALED);
+        flags = board.Bits().Words(BitBoard::FLAG);
+        pixels.resize((size_t)rows * columns);
+
+        for (int row = 0; row < rows; row++)
+        {
+            for (int col = 0; col < columns; col++)
+                pixels[(size_t)row * columns + col] = CellColor(board.At(row, col), lost);
+        }
+
+        dirty_first_row = 0;
+        dirty_end_row = rows;
+    }
+
+    bool MinimapImage::Update(const Board &board)
+    {
+        // Losing changes the color of flags which are not revealed
+        if (board.Rows() != rows || board.Columns() != columns || board.Lost() != lost)
+        {
+            Rebuild(board);
+            return true;
+        }
+
+        const std::vector<uint64_t> &board_revealed = board.Bits().Words(BitBoard::REVEALED);
+        const std::vector<uint64_t> &board_flags = board.Bits().Words(BitBoard::FLAG);
+        for (size_t w = 0; w < revealed.size(); w++)
+        {
+            uint64_t changed = (board_revealed[w] ^ revealed[w]) | (board_flags[w] ^ flags[w]);
+            if (!changed)
+                continue;
+
+            revealed[w] = board_revealed[w];
+            flags[w] = board_flags[w];
+            int first = (int)(w * 64 + __builtin_ctzll(changed));
+            int last = (int)(w * 64 + 63 - __builtin_clzll(changed));
+            MarkDirty(first / columns, last / columns + 1);
+
+            // Recoloring the unchanged cells in between is cheaper than picking the changed bits,
+            // a word spans at most a few rows
+            for (int index = first; index <= last;)
+            {
+                int row = index / columns;
+                int end = std::min(last + 1, (row + 1) * columns);
+                const Cell *cell = &board.At(row, index - row * columns);
+                for (; index < end; index++, cell++)
+                    pixels[index] = CellColor(*cell, lost);
+            }
+        }
+
+        return Dirty();
+    }
+}
@@ -0,0 +1,105 @@
+#ifndef MINIMAP_IMAGE_H
+#define MINIMAP_IMAGE_H
+
+#include <vector>
+#include <cstdint>
+#include "board.h"
+
+namespace minis
+{
+    /**
+     * @brief RGBA pixel in memory order, as uploaded to an R8G8B8A8 texture.
+     *
+     */
+    struct MinimapPixel
+    {
+        uint8_t r;
+        uint8_t g;
+        uint8_t b;
+        uint8_t a;
+    };
+
+    /**
+     * @brief Overview of a board with one pixel per cell, colored by its state (concealed, open,
+     * number, flag, mine or exploded mine).
+     * `Update` compares the revealed and flag planes of the board with the ones it drew last and
+     * only recolors the cells which changed. The changed rows form one band, so the texture behind
+     * it is brought up to date with a single partial upload however many cells a click opened.
+     *
+     */
+    class MinimapImage
+    {
+    public:
+        /**
+         * @brief Construct a new MinimapImage object and draw every cell of the board.
+         *
+         */
+        explicit MinimapImage(const Board &board);
+
+        /**
+         * @brief Recolors every cell and marks all rows dirty.
+         *
+         */
+        void Rebuild(const Board &board);
+
+        /**
+         * @brief Recolors the cells which changed since the last update and adds their rows to
+         * the dirty band. Does not allocate.
+         *
+         * @return true Some rows are dirty.
+         * @return false The image matches the board and was uploaded.
+         */
+        bool Update(const Board &board);
+
+        /**
+         * @brief Returns the first pixel of a row, the rows are stored back to back.
+         *
+         */
+        inline const MinimapPixel *Row(int row) const { return &pixels[(size_t)row * columns]; }
+
+        inline int Rows() const { return rows; }
+        inline int Columns() const { return columns; }
+
+        inline bool Dirty() const { return dirty_first_row < dirty_end_row; }
+        inline int DirtyFirstRow() const { return dirty_first_row; }
+        inline int DirtyEndRow() const { return dirty_end_row; }
+
+        /**
+         * @brief Marks the image as uploaded.
+         *
+         */
+        inline void ClearDirty()
+        {
+            dirty_first_row = rows;
+            dirty_end_row = 0;
+        }
+
+        /**
+         * @brief Returns the color of a cell.
+         *
+         * @param cell Gameplay state of the cell.
+         * @param game_over Game over state of the board.
+         */
+        static MinimapPixel CellColor(const Cell &cell, bool game_over);
+
+    private:
+        int rows;
+        int columns;
+        bool lost;
+        std::vector<MinimapPixel> pixels;
+        std::vector<uint64_t> revealed;
+        std::vector<uint64_t> flags;
+        int dirty_first_row;
+        int dirty_end_row;
+
+        inline void MarkDirty(int first_row, int end_row)
+        {
+            if (first_row < dirty_first_row)
+                dirty_first_row = first_row;
+            if (end_row > dirty_end_row)
+                dirty_end_row = end_row;
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,182 @@
+#include "neighbor_count.h"
+#include <cstring>
+#include <vector>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define MINIS_X86_DISPATCH
+#endif
+
+namespace minis
+{
+    namespace
+    {
+        typedef void (*RowSum)(const uint8_t *a, const uint8_t *b, const uint8_t *c, uint8_t *out, int count);
+        typedef void (*RowBoxSum)(const uint8_t *sums, const uint8_t *self, uint8_t *out, int count);
+
+        // out[i] = a[i] + b[i] + c[i]
+        void VerticalSumScalar(const uint8_t *a, const uint8_t *b, const uint8_t *c, uint8_t *out, int count)
+        {
+            for (int i = 0; i < count; i++)
+                out[i] = a[i] + b[i] + c[i];
+        }
+
+        // out[i] = sums[i] + sums[i + 1] + sums[i + 2] - self[i], `sums` is padded by one cell on both sides
+        void HorizontalSumScalar(const uint8_t *sums, const uint8_t *self, uint8_t *out, int count)
+        {
+            for (int i = 0; i < count; i++)
+                out[i] = sums[i] + sums[i + 1] + sums[i + 2] - self[i];
+        }
+
+#if defined(__SSE2__)
+        void VerticalSumSSE2(const uint8_t *a, const uint8_t *b, const uint8_t *c, uint8_t *out, int count)
+        {
+            int i = 0;
+            for (; i + 16 <= count; i += 16)
+            {
+                __m128i sum = _mm_add_epi8(_mm_loadu_si128((const __m128i *)(a + i)),
+                                           _mm_loadu_si128((const __m128i *)(b + i)));
+                sum = _mm_add_epi8(sum, _mm_loadu_si128((const __m128i *)(c + i)));
+                _mm_storeu_si128((__m128i *)(out + i), sum);
+            }
+            VerticalSumScalar(a + i, b + i, c + i, out + i, count - i);
+        }
+
+        void HorizontalSumSSE2(const uint8_t *sums, const uint8_t *self, uint8_t *out, int count)
+        {
+            int i = 0;
+            for (; i + 16 <= count; i += 16)
+            {
+                __m128i sum = _mm_add_epi8(_mm_loadu_si128((const __m128i *)(sums + i)),
+                                           _mm_loadu_si128((const __m128i *)(sums + i + 1)));
+                sum = _mm_add_epi8(sum, _mm_loadu_si128((const __m128i *)(sums + i + 2)));
+                sum = _mm_sub_epi8(sum, _mm_loadu_si128((const __m128i *)(self + i)));
+                _mm_storeu_si128((__m128i *)(out + i), sum);
+            }
+            HorizontalSumScalar(sums + i, self + i, out + i, count - i);
+        }
+#endif
+
+#if defined(MINIS_X86_DISPATCH)
+        __attribute__((target("avx2"))) void VerticalSumAVX2(const uint8_t *a, const uint8_t *b, const uint8_t *c, uint8_t *out, int count)
+        {
+            int i = 0;
+            for (; i + 32 <= count; i += 32)
+            {
+                __m256i sum = _mm256_add_epi8(_mm256_loadu_si256((const __m256i *)(a + i)),
+                                              _mm256_loadu_si256((const __m256i *)(b + i)));
+                sum = _mm256_add_epi8(sum, _mm256_loadu_si256((const __m256i *)(c + i)));
+                _mm256_storeu_si256((__m256i *)(out + i), sum);
+            }
+            VerticalSumScalar(a + i, b + i, c + i, out + i, count - i);
+        }
+
+        __attribute__((target("avx2"))) void HorizontalSumAVX2(const uint8_t *sums, const uint8_t *self, uint8_t *out, int count)
+        {
+            int i = 0;
+            for (; i + 32 <= count; i += 32)
+            {
+                __m256i sum = _mm256_add_epi8(_mm256_loadu_si256((const __m256i *)(sums + i)),
+                                              _mm256_loadu_si256((const __m256i *)(sums + i + 1)));
+                sum = _mm256_add_epi8(sum, _mm256_loadu_si256((const __m256i *)(sums + i + 2)));
+                sum = _mm256_sub_epi8(sum, _mm256_loadu_si256((const __m256i *)(self + i)));
+                _mm256_storeu_si256((__m256i *)(out + i), sum);
+            }
+            HorizontalSumScalar(sums + i, self + i, out + i, count - i);
+        }
+#endif
+
+        struct Kernel
+        {
+            const char *name;
+            RowSum vertical;
+            RowBoxSum horizontal;
+        };
+
+        /**
+         * @brief Looks up a kernel by name.
+         *
+         * @return true The kernel exists in this build and runs on this machine.
+         */
+        bool FindKernel(const char *name, Kernel *kernel)
+        {
+            if (strcmp(name, "scalar") == 0)
+            {
+                *kernel = Kernel{"scalar", VerticalSumScalar, HorizontalSumScalar};
+                return true;
+            }
+#if defined(__SSE2__)
+            if (strcmp(name, "sse2") == 0)
+            {
+                *kernel = Kernel{"sse2", VerticalSumSSE2, HorizontalSumSSE2};
+                return true;
+            }
+#endif
+#if defined(MINIS_X86_DISPATCH)
+            if (strcmp(name, "avx2") == 0 && __builtin_cpu_supports("avx2"))
+            {
+                *kernel = Kernel{"avx2", VerticalSumAVX2, HorizontalSumAVX2};
+                return true;
+            }
+#endif
+            return false;
+        }
+
+        Kernel SelectKernel()
+        {
+            Kernel kernel;
+            if (FindKernel("avx2", &kernel) || FindKernel("sse2", &kernel))
+                return kernel;
+            FindKernel("scalar", &kernel);
+            return kernel;
+        }
+
+        const Kernel &ActiveKernel()
+        {
+            static const Kernel kernel = SelectKernel();
+            return kernel;
+        }
+
+        void CountNeighborMines(const Kernel &kernel, const uint8_t *mines, int rows, int columns, uint8_t *counts)
+        {
+            std::vector<uint8_t> zero_row(columns, 0);
+            // Vertical sums of the current row, with a zero cell left and right of the board
+            std::vector<uint8_t> sums(columns + 2, 0);
+
+            for (int row = 0; row < rows; row++)
+            {
+                const uint8_t *current = mines + (size_t)row * columns;
+                const uint8_t *above = row > 0 ? current - columns : zero_row.data();
+                const uint8_t *below = row < rows - 1 ? current + columns : zero_row.data();
+
+                kernel.vertical(above, current, below, sums.data() + 1, columns);
+                kernel.horizontal(sums.data(), current, counts + (size_t)row * columns, columns);
+            }
+        }
+    }
+
+    void CountNeighborMines(const uint8_t *mines, int rows, int columns, uint8_t *counts)
+    {
+        CountNeighborMines(ActiveKernel(), mines, rows, columns, counts);
+    }
+
+    void CountNeighborMinesScalar(const uint8_t *mines, int rows, int columns, uint8_t *counts)
+    {
+        CountNeighborMines(Kernel{"scalar", VerticalSumScalar, HorizontalSumScalar}, mines, rows, columns, counts);
+    }
+
+    bool CountNeighborMinesWith(const char *kernel_name, const uint8_t *mines, int rows, int columns, uint8_t *counts)
+    {
+        Kernel kernel;
+        if (!FindKernel(kernel_name, &kernel))
+            return false;
+
+        CountNeighborMines(kernel, mines, rows, columns, counts);
+        return true;
+    }
+
+    const char *NeighborCountKernel()
+    {
+        return ActiveKernel().name;
+    }
+}
@@ -0,0 +1,45 @@
+#ifndef NEIGHBOR_COUNT_H
+#define NEIGHBOR_COUNT_H
+
+#include <cstdint>
+
+namespace minis
+{
+    /**
+     * @brief Computes the number of adjacent mines for every cell of a board at once as 3x3 box sum
+     * (minus the cell itself). Every row is summed vertically with its upper and lower neighbor row
+     * into a zero padded row buffer, which is then summed horizontally. Both passes run on 32 (AVX2)
+     * or 16 (SSE2) cells per instruction, the instruction set is selected at runtime.
+     *
+     * @param mines One byte per cell (row-major), 1 for a mine and 0 otherwise.
+     * @param rows Number of rows.
+     * @param columns Number of columns.
+     * @param counts Receives one byte per cell (row-major) with the number of adjacent mines.
+     */
+    void CountNeighborMines(const uint8_t *mines, int rows, int columns, uint8_t *counts);
+
+    /**
+     * @brief Same as `CountNeighborMines`, but restricted to plain scalar code.
+     *
+     */
+    void CountNeighborMinesScalar(const uint8_t *mines, int rows, int columns, uint8_t *counts);
+
+    /**
+     * @brief Same as `CountNeighborMines`, but with a given instruction set instead of the best
+     * one, so every kernel can be checked on one machine.
+     *
+     * @param kernel_name "avx2", "sse2" or "scalar".
+     * @return true The counts were computed.
+     * @return false The kernel is not part of this build or not supported by this machine.
+     */
+    bool CountNeighborMinesWith(const char *kernel_name, const uint8_t *mines, int rows, int columns, uint8_t *counts);
+
+    /**
+     * @brief Returns the name of the instruction set used by `CountNeighborMines` on this machine.
+     *
+     * @return const char* "avx2", "sse2" or "scalar".
+     */
+    const char *NeighborCountKernel();
+}
+
+#endif
@@ -0,0 +1,84 @@
+#include <cstdio>
+#include <vector>
+#include "neighbor_count.h"
+#include "rng.h"
+
+using namespace ::minis;
+
+#define MAX_TEST_SIZE 70
+
+/**
+ * @brief Counts the neighbors cell by cell, the reference for the scalar kernel.
+ *
+ */
+static void CountNaive(const std::vector<uint8_t> &mines, int rows, int columns, std::vector<uint8_t> *counts)
+{
+    for (int row = 0; row < rows; row++)
+    {
+        for (int col = 0; col < columns; col++)
+        {
+            int count = 0;
+            for (int r = row - 1; r <= row + 1; r++)
+            {
+                for (int c = col - 1; c <= col + 1; c++)
+                    count += (r != row || c != col) && r >= 0 && r < rows && c >= 0 && c < columns && mines[r * columns + c];
+            }
+            (*counts)[row * columns + col] = count;
+        }
+    }
+}
+
+/**
+ * @brief Checks the SSE2 and AVX2 kernels against `CountNeighborMinesScalar` (and that against a
+ * cell by cell count) on every width from 1 to `MAX_TEST_SIZE`, i. e. with every remainder after
+ * the full vectors, at random heights and densities, all mines included.
+ *
+ */
+int main()
+{
+    const char *kernels[] = {"sse2", "avx2"};
+    int failed = 0;
+    int checked[2] = {};
+    Rng rng(1);
+
+    for (int columns = 1; columns <= MAX_TEST_SIZE; columns++)
+    {
+        for (int board = 0; board < 4; board++)
+        {
+            int rows = 1 + (int)rng.Below(MAX_TEST_SIZE);
+            // From empty to full, so the counts reach 0 and 8
+            int density = board == 3 ? 100 : (int)rng.Below(101);
+            std::vector<uint8_t> mines(rows * columns);
+            for (uint8_t &mine : mines)
+                mine = (int)rng.Below(100) < density;
+
+            std::vector<uint8_t> expected(mines.size()), scalar(mines.size());
+            CountNaive(mines, rows, columns, &expected);
+            CountNeighborMinesScalar(mines.data(), rows, columns, scalar.data());
+            if (scalar != expected)
+            {
+                printf("scalar differs from the cell by cell count at %d x %d\n", rows, columns);
+                failed++;
+            }
+
+            for (int k = 0; k < 2; k++)
+            {
+                std::vector<uint8_t> counts(mines.size(), 0xFF);
+                if (!CountNeighborMinesWith(kernels[k], mines.data(), rows, columns, counts.data()))
+                    continue;
+
+                checked[k]++;
+                if (counts != scalar)
+                {
+                    printf("%s differs from scalar at %d x %d\n", kernels[k], rows, columns);
+                    failed++;
+                }
+            }
+        }
+    }
+
+    for (int k = 0; k < 2; k++)
+        printf("%s: %s\n", kernels[k], checked[k] ? "checked" : "not available, skipped");
+    printf("%d boards differ\n", failed);
+    return failed > 0 ? 1 : 0;
+}
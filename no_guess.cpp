@@ -0,0 +1,45 @@
+#include <utility>
+#include "no_guess.h"
+#include "rng.h"
+#include "solver.h"
+#include "mine_placement.h"
+
+namespace minis
+{
+    bool SolvableWithoutGuessing(const Board &board)
+    {
+        Board copy(board);
+        Solver solver(copy);
+        SolverMove move;
+
+        // Flags do not matter to the solver, only the safe moves have to be played
+        while (!copy.Won() && solver.NextSafe(&move))
+        {
+            copy.Reveal(move.row, move.col);
+            solver.Observe(copy.LastOpened());
+        }
+
+        return copy.Won();
+    }
+
+    bool GenerateNoGuess(int rows, int columns, int mines, uint64_t seed, Board *board, int max_attempts)
+    {
+        Rng rng(seed);
+
+        for (int attempt = 0; attempt < max_attempts; attempt++)
+        {
+            int row = rng.Below(rows);
+            int col = rng.Below(columns);
+            Board candidate(rows, columns, mines, rng.Next(), SafeZone(rows, columns, row, col));
+            candidate.Reveal(row, col);
+
+            if (SolvableWithoutGuessing(candidate))
+            {
+                *board = std::move(candidate);
+                return true;
+            }
+        }
+
+        return false;
+    }
+}
@@ -0,0 +1,39 @@
+#ifndef NO_GUESS_H
+#define NO_GUESS_H
+
+#include <cstdint>
+#include "board.h"
+
+#define NO_GUESS_MAX_ATTEMPTS 10000
+
+namespace minis
+{
+    /**
+     * @brief Checks if the solver can clear a board from its current position without guessing.
+     * The board itself is not changed.
+     *
+     * @param board Board with at least one opened cell.
+     * @return true Every remaining cell can be deduced.
+     * @return false The solver gets stuck at some point.
+     */
+    bool SolvableWithoutGuessing(const Board &board);
+
+    /**
+     * @brief Creates a board which can be cleared without guessing. Random layouts are generated,
+     * opened on a random cell (which is free of mines, as are its neighbors) and kept once the
+     * solver clears them. Rejecting layouts keeps every solvable layout equally likely.
+     *
+     * @param rows Number of rows.
+     * @param columns Number of columns.
+     * @param mines Number of mines.
+     * @param seed Seed for the layouts and opening cells.
+     * @param board Receives the board with the opening already revealed.
+     * @param max_attempts Number of layouts to try before giving up.
+     * @return true A board was found.
+     * @return false No layout of `max_attempts` could be cleared, `board` is unchanged. Try
+     * again with another seed or fall back to a random board.
+     */
+    bool GenerateNoGuess(int rows, int columns, int mines, uint64_t seed, Board *board, int max_attempts = NO_GUESS_MAX_ATTEMPTS);
+}
+
+#endif
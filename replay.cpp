@@ -0,0 +1,329 @@
+#include "replay.h"
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
+namespace minis
+{
+    namespace
+    {
+        const char MAGIC[4] = {'M', 'S', 'R', 'P'};
+        const uint16_t VERSION = 1;
+
+        void PutU16(std::vector<uint8_t> &out, uint16_t value)
+        {
+            for (int i = 0; i < 2; i++)
+                out.push_back((uint8_t)(value >> (8 * i)));
+        }
+
+        void PutU32(std::vector<uint8_t> &out, uint32_t value)
+        {
+            for (int i = 0; i < 4; i++)
+                out.push_back((uint8_t)(value >> (8 * i)));
+        }
+
+        void PutU64(std::vector<uint8_t> &out, uint64_t value)
+        {
+            for (int i = 0; i < 8; i++)
+                out.push_back((uint8_t)(value >> (8 * i)));
+        }
+
+        void PutVarint(std::vector<uint8_t> &out, uint64_t value)
+        {
+            while (value >= 0x80)
+            {
+                out.push_back((uint8_t)(value | 0x80));
+                value >>= 7;
+            }
+            out.push_back((uint8_t)value);
+        }
+
+        void PutWords(std::vector<uint8_t> &out, const std::vector<uint64_t> &words)
+        {
+            for (uint64_t word : words)
+                PutU64(out, word);
+        }
+
+        /**
+         * @brief Bounds checked little endian reader, every read fails once the data ran out.
+         *
+         */
+        struct Reader
+        {
+            const uint8_t *data;
+            size_t size;
+            size_t offset = 0;
+
+            bool Get(uint64_t *value, int bytes)
+            {
+                if (size - offset < (size_t)bytes)
+                    return false;
+                *value = 0;
+                for (int i = 0; i < bytes; i++)
+                    *value |= (uint64_t)data[offset + i] << (8 * i);
+                offset += bytes;
+                return true;
+            }
+
+            bool GetVarint(uint64_t *value)
+            {
+                *value = 0;
+                for (int shift = 0; shift < 64 && offset < size; shift += 7)
+                {
+                    uint8_t byte = data[offset++];
+                    *value |= (uint64_t)(byte & 0x7f) << shift;
+                    if (!(byte & 0x80))
+                        return true;
+                }
+                return false;
+            }
+
+            bool GetWords(std::vector<uint64_t> *words, size_t count)
+            {
+                if ((size - offset) / 8 < count)
+                    return false;
+                words->resize(count);
+                for (uint64_t &word : *words)
+                    Get(&word, 8);
+                return true;
+            }
+        };
+    }
+
+    Board Replay::InitialBoard() const
+    {
+        Board board(rows, columns, layout, seed);
+
+        // Games resumed from a snapshot start with a keyframe of the resumed position
+        if (!keyframes.empty() && keyframes.front().event_index == 0)
+            board.RestoreState(keyframes.front().state);
+        return board;
+    }
+
+    std::vector<uint8_t> Replay::Encode() const
+    {
+        std::vector<uint8_t> out(MAGIC, MAGIC + 4);
+        PutU16(out, VERSION);
+        PutU16(out, (uint16_t)keyframe_interval);
+        PutU32(out, rows);
+        PutU32(out, columns);
+        PutU32(out, mines);
+        PutU64(out, seed);
+        PutU32(out, (uint32_t)events.size());
+        PutU32(out, (uint32_t)keyframes.size());
+        PutWords(out, layout);
+
+        for (const ReplayKeyframe &keyframe : keyframes)
+        {
+            PutU32(out, keyframe.event_index);
+            PutU32(out, keyframe.frame);
+            PutU32(out, keyframe.state.open_count);
+            PutU32(out, (uint32_t)keyframe.state.triggered);
+            PutWords(out, keyframe.state.revealed);
+            PutWords(out, keyframe.state.flags);
+        }
+
+        uint32_t frame = 0;
+        for (const ReplayEvent &event : events)
+        {
+            PutVarint(out, event.frame - frame);
+            PutVarint(out, ((uint64_t)event.row * columns + event.col) << 1 | (uint64_t)event.action);
+            frame = event.frame;
+        }
+
+        return out;
+    }
+
+    bool Replay::Decode(const uint8_t *data, size_t size, Replay *replay)
+    {
+        Reader reader{data, size};
+        uint64_t version, interval, rows, columns, mines, seed, event_count, keyframe_count;
+
+        if (size < 4 || !std::equal(MAGIC, MAGIC + 4, data))
+            return false;
+        reader.offset = 4;
+        if (!reader.Get(&version, 2) || version != VERSION || !reader.Get(&interval, 2) || interval == 0 ||
+            !reader.Get(&rows, 4) || !reader.Get(&columns, 4) || !reader.Get(&mines, 4) || !reader.Get(&seed, 8) ||
+            !reader.Get(&event_count, 4) || !reader.Get(&keyframe_count, 4))
+            return false;
+        if (rows == 0 || columns == 0 || rows * columns > (uint64_t)INT32_MAX || mines > rows * columns)
+            return false;
+
+        Replay result;
+        size_t words = (rows * columns + 63) / 64;
+        result.rows = (int)rows;
+        result.columns = (int)columns;
+        result.mines = (int)mines;
+        result.seed = seed;
+        result.keyframe_interval = (int)interval;
+        if (!reader.GetWords(&result.layout, words))
+            return false;
+
+        for (uint64_t k = 0; k < keyframe_count; k++)
+        {
+            ReplayKeyframe keyframe;
+            uint64_t event_index, frame, open_count, triggered;
+            if (!reader.Get(&event_index, 4) || !reader.Get(&frame, 4) || !reader.Get(&open_count, 4) ||
+                !reader.Get(&triggered, 4) || event_index > event_count ||
+                !reader.GetWords(&keyframe.state.revealed, words) || !reader.GetWords(&keyframe.state.flags, words))
+                return false;
+
+            keyframe.event_index = (int)event_index;
+            keyframe.frame = (uint32_t)frame;
+            keyframe.state.open_count = (int)open_count;
+            keyframe.state.triggered = (int32_t)(uint32_t)triggered;
+            result.keyframes.push_back(std::move(keyframe));
+        }
+
+        uint64_t frame = 0;
+        result.events.reserve(std::min<uint64_t>(event_count, size));
+        for (uint64_t e = 0; e < event_count; e++)
+        {
+            uint64_t delta, packed;
+            if (!reader.GetVarint(&delta) || !reader.GetVarint(&packed) || (packed >> 1) >= rows * columns)
+                return false;
+
+            frame += delta;
+            uint64_t index = packed >> 1;
+            result.events.push_back(ReplayEvent{(uint32_t)frame, (ReplayAction)(packed & 1), (int)(index / columns), (int)(index % columns)});
+        }
+
+        *replay = std::move(result);
+        return true;
+    }
+
+    bool Replay::Save(const std::string &path) const
+    {
+        std::vector<uint8_t> data = Encode();
+        std::ofstream file(path, std::ios::binary);
+        file.write((const char *)data.data(), data.size());
+        return (bool)file;
+    }
+
+    bool Replay::Load(const std::string &path, Replay *replay)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+            return false;
+
+        std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        return Decode(data.data(), data.size(), replay);
+    }
+
+    ReplayRecorder::ReplayRecorder(const Board &board, int keyframe_interval)
+        : board(board)
+    {
+        replay.rows = board.Rows();
+        replay.columns = board.Columns();
+        replay.mines = board.MineCount();
+        replay.keyframe_interval = keyframe_interval;
+
+        if (board.OpenCount() > 0 || board.FlagCount() > 0 || board.Lost())
+            replay.keyframes.push_back(ReplayKeyframe{0, 0, board.SaveState()});
+    }
+
+    void ReplayRecorder::Record(uint32_t frame, ReplayAction action, int row, int col)
+    {
+        replay.events.push_back(ReplayEvent{frame, action, row, col});
+
+        if (replay.events.size() % replay.keyframe_interval == 0)
+            replay.keyframes.push_back(ReplayKeyframe{(int)replay.events.size(), frame, board.SaveState()});
+    }
+
+    Replay ReplayRecorder::Finish() const
+    {
+        // The layout only changes up to the first reveal (safe first click), so it is taken at the end
+        Replay result(replay);
+        result.seed = board.Seed();
+        result.layout = board.Bits().Words(BitBoard::MINE);
+
+        if (result.keyframes.empty() || result.keyframes.back().event_index != (int)result.events.size())
+        {
+            uint32_t frame = result.events.empty() ? 0 : result.events.back().frame;
+            result.keyframes.push_back(ReplayKeyframe{(int)result.events.size(), frame, board.SaveState()});
+        }
+
+        return result;
+    }
+
+    ReplayPlayer::ReplayPlayer(const Replay &replay, Board *board)
+        : replay(replay), board(board), initial(board->SaveState())
+    {
+    }
+
+    void ReplayPlayer::Seek(int move)
+    {
+        move = std::max(0, std::min(move, Moves()));
+
+        // Keyframes are taken every interval, the last one may be off the grid and resumed games
+        // have an additional one at the start
+        int keyframe = move / replay.keyframe_interval;
+        while (keyframe >= (int)replay.keyframes.size() ||
+               (keyframe >= 0 && replay.keyframes[keyframe].event_index > move))
+            keyframe--;
+
+        if (keyframe >= 0)
+        {
+            board->RestoreState(replay.keyframes[keyframe].state);
+            position = replay.keyframes[keyframe].event_index;
+        }
+        else
+        {
+            board->RestoreState(initial);
+            position = 0;
+        }
+
+        while (position < move)
+            Step();
+    }
+
+    bool ReplayPlayer::Step()
+    {
+        if (Done())
+            return false;
+        ApplyReplayEvent(board, replay.events[position++]);
+        return true;
+    }
+
+    int ReplayPlayer::AdvanceTo(uint32_t frame, int max_events)
+    {
+        int applied = 0;
+        while (applied < max_events && !Done() && replay.events[position].frame <= frame)
+        {
+            Step();
+            applied++;
+        }
+        return applied;
+    }
+
+    bool ApplyReplayEvent(Board *board, const ReplayEvent &event)
+    {
+        if (event.action == ReplayAction::Flag)
+            return board->ToggleFlag(event.row, event.col);
+        return board->Reveal(event.row, event.col) != RevealResult::Ignored;
+    }
+
+    bool VerifyReplay(const Replay &replay)
+    {
+        Board board = replay.InitialBoard();
+        size_t keyframe = 0;
+
+        if (board.MineCount() != replay.mines)
+            return false;
+
+        for (size_t e = 0; e <= replay.events.size(); e++)
+        {
+            while (keyframe < replay.keyframes.size() && replay.keyframes[keyframe].event_index == (int)e)
+            {
+                if (!(board.SaveState() == replay.keyframes[keyframe].state))
+                    return false;
+                keyframe++;
+            }
+
+            if (e < replay.events.size() && !ApplyReplayEvent(&board, replay.events[e]))
+                return false;
+        }
+
+        return keyframe == replay.keyframes.size();
+    }
+}
@@ -0,0 +1,204 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+#include "board.h"
+
+#define REPLAY_KEYFRAME_INTERVAL 32
+
+namespace minis
+{
+    enum class ReplayAction : uint8_t
+    {
+        Reveal = 0,
+        Flag,
+    };
+
+    /**
+     * @brief One action which changed the board, `frame` counts the frames since the game started.
+     *
+     */
+    struct ReplayEvent
+    {
+        uint32_t frame;
+        ReplayAction action;
+        int row;
+        int col;
+    };
+
+    /**
+     * @brief State of the board after the first `event_index` events.
+     *
+     */
+    struct ReplayKeyframe
+    {
+        int event_index;
+        uint32_t frame;
+        BoardState state;
+    };
+
+    /**
+     * @brief A recorded game: the mine layout, every action in order and a keyframe every
+     * `keyframe_interval` actions, so any position is reached by replaying less than
+     * `keyframe_interval` actions.
+     *
+     * File format (little endian): "MSRP", u16 version, u16 keyframe interval, u32 rows, columns,
+     * mines, u64 seed, u32 event count, u32 keyframe count, the mine plane (u64 words), the keyframes
+     * (u32 event index, u32 frame, u32 open count, i32 triggered cell, revealed and flag plane) and
+     * the events, two LEB128 varints each: frame delta and `(row * columns + col) << 1 | action`.
+     *
+     */
+    struct Replay
+    {
+        int rows = 0;
+        int columns = 0;
+        int mines = 0;
+        uint64_t seed = 0;
+        int keyframe_interval = REPLAY_KEYFRAME_INTERVAL;
+        std::vector<uint64_t> layout;
+        std::vector<ReplayEvent> events;
+        std::vector<ReplayKeyframe> keyframes;
+
+        /**
+         * @brief Returns the board as it was before the first event, with the state of a leading
+         * keyframe applied.
+         *
+         */
+        Board InitialBoard() const;
+
+        std::vector<uint8_t> Encode() const;
+
+        /**
+         * @brief Decodes a replay from its binary form.
+         *
+         * @param data Encoded replay.
+         * @param size Size of the encoded replay in bytes.
+         * @param replay Receives the replay.
+         * @return true The replay was decoded.
+         * @return false The data is not a valid replay.
+         */
+        static bool Decode(const uint8_t *data, size_t size, Replay *replay);
+
+        bool Save(const std::string &path) const;
+        static bool Load(const std::string &path, Replay *replay);
+    };
+
+    /**
+     * @brief Records the actions applied to a board and takes the keyframes.
+     *
+     */
+    class ReplayRecorder
+    {
+    public:
+        /**
+         * @brief Construct a new ReplayRecorder object. A board which has already been played
+         * (i. e. resumed from a snapshot) is stored as a keyframe before the first event.
+         *
+         * @param board Recorded board, has to outlive the recorder.
+         * @param keyframe_interval Number of events between two keyframes.
+         */
+        explicit ReplayRecorder(const Board &board, int keyframe_interval = REPLAY_KEYFRAME_INTERVAL);
+
+        /**
+         * @brief Records an action. Call it after the action has been applied to the board and
+         * only for actions which changed the board.
+         *
+         */
+        void Record(uint32_t frame, ReplayAction action, int row, int col);
+
+        /**
+         * @brief Returns the replay of everything recorded so far, with a keyframe of the
+         * current position at the end.
+         *
+         */
+        Replay Finish() const;
+
+        inline int Events() const { return (int)replay.events.size(); }
+
+    private:
+        const Board &board;
+        Replay replay;
+    };
+
+    /**
+     * @brief Plays a replay back on a board, forwards or by seeking to any position.
+     *
+     */
+    class ReplayPlayer
+    {
+    public:
+        ReplayPlayer() = default;
+
+        /**
+         * @brief Construct a new ReplayPlayer object.
+         *
+         * @param replay Replay to play.
+         * @param board Board created by `replay.InitialBoard()`, has to outlive the player.
+         */
+        ReplayPlayer(const Replay &replay, Board *board);
+
+        /**
+         * @brief Moves the board to the position after `move` events: restores the closest
+         * keyframe before it and replays the remaining (less than one interval of) events.
+         *
+         * @param move Number of events to have applied, clamped to the replay.
+         */
+        void Seek(int move);
+
+        /**
+         * @brief Applies the next event.
+         *
+         * @return true An event was applied.
+         * @return false The replay is over.
+         */
+        bool Step();
+
+        /**
+         * @brief Applies the events up to a frame.
+         *
+         * @param frame Frame to play up to.
+         * @param max_events Upper bound of events to apply.
+         * @return int Number of events applied.
+         */
+        int AdvanceTo(uint32_t frame, int max_events);
+
+        inline int Position() const { return position; }
+        inline int Moves() const { return (int)replay.events.size(); }
+        inline bool Done() const { return position >= Moves(); }
+
+        /**
+         * @brief Returns the frame of the last applied event.
+         *
+         */
+        inline uint32_t Frame() const { return position > 0 ? replay.events[position - 1].frame : 0; }
+
+    private:
+        Replay replay;
+        Board *board = nullptr;
+        BoardState initial;
+        int position = 0;
+    };
+
+    /**
+     * @brief Applies an event to a board.
+     *
+     * @return true The event changed the board.
+     * @return false The event was ignored.
+     */
+    bool ApplyReplayEvent(Board *board, const ReplayEvent &event);
+
+    /**
+     * @brief Replays a game from the start and checks that every event changes the board and that
+     * every keyframe matches the replayed position, i. e. that the game logic is deterministic.
+     *
+     * @param replay Replay to check.
+     * @return true The replay reproduces.
+     * @return false The replay diverged.
+     */
+    bool VerifyReplay(const Replay &replay);
+}
+
+#endif
@@ -0,0 +1,114 @@
+#include <cstdio>
+#include <vector>
+#include "board.h"
+#include "replay.h"
+#include "mine_placement.h"
+#include "rng.h"
+
+using namespace ::minis;
+
+static int failed = 0;
+
+static void Check(bool condition, const char *what, int game)
+{
+    if (condition)
+        return;
+    printf("FAILED (game %d): %s\n", game, what);
+    failed++;
+}
+
+/**
+ * @brief Plays a random game with reveals, flags and removed flags and records it.
+ *
+ * @param states Receives the board state before the first and after every recorded event.
+ */
+static Replay PlayGame(int game, int keyframe_interval, std::vector<BoardState> *states)
+{
+    Rng rng(game + 1);
+    int rows = 16, columns = 30, mines = 99;
+    int first_row = (int)rng.Below(rows), first_col = (int)rng.Below(columns);
+    Board board(rows, columns, mines, rng.Next(), SafeZone(rows, columns, first_row, first_col));
+    ReplayRecorder recorder(board, keyframe_interval);
+    uint32_t frame = 0;
+
+    states->assign(1, board.SaveState());
+    board.Reveal(first_row, first_col);
+    recorder.Record(frame, ReplayAction::Reveal, first_row, first_col);
+    states->push_back(board.SaveState());
+
+    while (!board.Won() && !board.Lost())
+    {
+        frame += 1 + (uint32_t)rng.Below(200);
+        int row = (int)rng.Below(rows), col = (int)rng.Below(columns);
+        // Mostly reveals, which would end the game on the first mine, so mines are flagged instead
+        bool flag = board.At(row, col).mine ? rng.Below(8) != 0 : rng.Below(4) == 0;
+
+        if (flag && board.ToggleFlag(row, col))
+            recorder.Record(frame, ReplayAction::Flag, row, col);
+        else if (!flag && board.Reveal(row, col) != RevealResult::Ignored)
+            recorder.Record(frame, ReplayAction::Reveal, row, col);
+        else
+            continue;
+        states->push_back(board.SaveState());
+    }
+
+    return recorder.Finish();
+}
+
+/**
+ * @brief Round trip of recorded games: encode, decode, verify, and seek and step the player
+ * against the recorded board states.
+ *
+ */
+int main()
+{
+    for (int game = 0; game < 50; game++)
+    {
+        std::vector<BoardState> states;
+        Replay recorded = PlayGame(game, game % 2 ? REPLAY_KEYFRAME_INTERVAL : 4, &states);
+        int moves = (int)recorded.events.size();
+        Check(moves + 1 == (int)states.size(), "every action is recorded", game);
+        Check(VerifyReplay(recorded), "the recorded replay verifies", game);
+
+        std::vector<uint8_t> encoded = recorded.Encode();
+        Replay replay;
+        if (!Replay::Decode(encoded.data(), encoded.size(), &replay))
+        {
+            Check(false, "the encoded replay decodes", game);
+            continue;
+        }
+        Check(replay.Encode() == encoded, "decoding and encoding again gives the same bytes", game);
+        Check(replay.seed == recorded.seed && replay.layout == recorded.layout && replay.keyframes.size() == recorded.keyframes.size(),
+              "the decoded replay keeps the board and the keyframes", game);
+        Check(VerifyReplay(replay), "the decoded replay verifies", game);
+        Replay truncated;
+        Check(!Replay::Decode(encoded.data(), encoded.size() / 2, &truncated), "a truncated replay is rejected", game);
+
+        // The game ends with a reveal, flagging that cell instead leaves a different board
+        Replay tampered = recorded;
+        tampered.events.back().action = ReplayAction::Flag;
+        Check(!VerifyReplay(tampered), "a changed event does not verify", game);
+
+        // Seeking restores a keyframe and replays the rest, stepping applies one event
+        Board board = replay.InitialBoard();
+        ReplayPlayer player(replay, &board);
+        Rng rng(game);
+        for (int seek = 0; seek < 20; seek++)
+        {
+            int move = seek == 0 ? moves : (int)rng.Below(moves + 1);
+            player.Seek(move);
+            Check(player.Position() == move && board.SaveState() == states[move], "Seek reaches the recorded state", game);
+
+            for (int step = 0; step < 5 && !player.Done(); step++)
+            {
+                player.Step();
+                Check(board.SaveState() == states[player.Position()], "Step reaches the recorded state", game);
+            }
+        }
+        player.Seek(0);
+        Check(board.SaveState() == states[0] && !board.Lost(), "seeking back to the start restores the initial board", game);
+    }
+
+    printf("%d checks failed\n", failed);
+    return failed > 0 ? 1 : 0;
+}
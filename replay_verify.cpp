@@ -0,0 +1,40 @@
+#include <chrono>
+#include <cstdio>
+#include "replay.h"
+
+using namespace ::minis;
+
+/**
+ * @brief Replays recorded games headless and checks that they reproduce move by move.
+ *
+ */
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "Usage: %s <replay>...\n", argv[0]);
+        return 1;
+    }
+
+    int failed = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    for (int i = 1; i < argc; i++)
+    {
+        Replay replay;
+        if (!Replay::Load(argv[i], &replay))
+        {
+            printf("%s: not a valid replay\n", argv[i]);
+            failed++;
+        }
+        else if (!VerifyReplay(replay))
+        {
+            printf("%s: diverged\n", argv[i]);
+            failed++;
+        }
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    printf("%d replays, %d failed, %.0f replays/s\n", argc - 1, failed, (argc - 1) / elapsed.count());
+    return failed > 0 ? 1 : 0;
+}
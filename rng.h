@@ -0,0 +1,60 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <cstdint>
+
+namespace minis
+{
+    /**
+     * @brief Small, fast and deterministic pseudo random number generator (SplitMix64).
+     * Two generators created with the same seed always produce the same sequence, which
+     * makes boards reproducible without depending on raylib's global random state.
+     */
+    class Rng
+    {
+    public:
+        explicit Rng(uint64_t seed = 0) : state(seed) {}
+
+        /**
+         * @brief Returns the next 64 bit random value.
+         *
+         * @return uint64_t Random value.
+         */
+        inline uint64_t Next()
+        {
+            uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            return z ^ (z >> 31);
+        }
+
+        /**
+         * @brief Returns a random value in the range [0, bound).
+         *
+         * @param bound Exclusive upper bound, must be greater than 0.
+         * @return uint32_t Random value lower than `bound`.
+         */
+        inline uint32_t Below(uint32_t bound)
+        {
+            // Lemire's multiply-shift reduction, the bias is negligible for board sizes.
+            return (uint32_t)(((Next() >> 32) * (uint64_t)bound) >> 32);
+        }
+
+        /**
+         * @brief Returns a random value in the range [min, max] (like raylib's `GetRandomValue`).
+         *
+         * @param min Inclusive lower bound.
+         * @param max Inclusive upper bound.
+         * @return int Random value between `min` and `max`.
+         */
+        inline int Range(int min, int max)
+        {
+            return min + (int)Below((uint32_t)(max - min + 1));
+        }
+
+    private:
+        uint64_t state;
+    };
+}
+
+#endif
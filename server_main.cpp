@@ -0,0 +1,365 @@
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "game_server.h"
+
+using namespace ::minis;
+
+#define SERVER_DEFAULT_SOCKET "/tmp/minisweeper.sock"
+#define SERVER_READ_SIZE 65536
+// A client which lets this much pile up without reading is dropped
+#define SERVER_MAX_PENDING_BYTES (64 << 20)
+
+static volatile sig_atomic_t stop_requested = 0;
+
+static void RequestStop(int)
+{
+    stop_requested = 1;
+}
+
+/**
+ * @brief Client socket. The workers queue the responses and send what the socket takes right
+ * away, the rest is sent by the poll loop once the socket is writable again, so a slow reader
+ * never holds up a worker. The file descriptor is closed once the last queued request of the
+ * client is answered.
+ *
+ */
+class SocketConnection : public ServerConnection
+{
+public:
+    /**
+     * @param fd Non-blocking client socket, closed with the connection.
+     * @param wake_fd Written to when bytes are left for the poll loop.
+     */
+    SocketConnection(int fd, int wake_fd) : fd(fd), wake_fd(wake_fd) {}
+    ~SocketConnection() override { close(fd); }
+
+    void Send(const uint8_t *data, size_t size) override
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (failed)
+            return;
+        if (outgoing.size() + size > SERVER_MAX_PENDING_BYTES)
+        {
+            failed = true;
+            outgoing.clear();
+            Wake();
+            return;
+        }
+
+        // With bytes already waiting the poll loop sends these as well
+        bool waiting = !outgoing.empty();
+        outgoing.insert(outgoing.end(), data, data + size);
+        if (waiting)
+            return;
+
+        SendOutgoing();
+        if (!outgoing.empty() || failed)
+            Wake();
+    }
+
+    /**
+     * @brief Sends the queued bytes until the socket is full, the poll loop calls it once the
+     * socket is writable.
+     *
+     */
+    void Flush()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        SendOutgoing();
+    }
+
+    /**
+     * @brief Returns true if bytes wait for the socket to become writable.
+     *
+     */
+    bool Pending()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return !outgoing.empty();
+    }
+
+    /**
+     * @brief Returns true once sending failed, nothing is sent anymore.
+     *
+     */
+    bool Failed()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return failed;
+    }
+
+    inline int Fd() const { return fd; }
+
+private:
+    int fd;
+    int wake_fd;
+    std::mutex mutex;
+    std::vector<uint8_t> outgoing;
+    bool failed = false;
+
+    /**
+     * @brief Sends without blocking and keeps what the socket did not take. Has to be called
+     * with the mutex held.
+     *
+     */
+    void SendOutgoing()
+    {
+        size_t offset = 0;
+        while (offset < outgoing.size())
+        {
+            ssize_t sent = send(fd, outgoing.data() + offset, outgoing.size() - offset, MSG_NOSIGNAL);
+            if (sent > 0)
+            {
+                offset += sent;
+                continue;
+            }
+            if (sent < 0 && errno == EINTR)
+                continue;
+            if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+                break;
+
+            failed = true;
+            outgoing.clear();
+            return;
+        }
+        outgoing.erase(outgoing.begin(), outgoing.begin() + offset);
+    }
+
+    /**
+     * @brief Interrupts the poll of the main thread, so it watches the socket for writing.
+     *
+     */
+    void Wake()
+    {
+        uint8_t byte = 0;
+        while (write(wake_fd, &byte, 1) < 0 && errno == EINTR)
+        {
+        }
+    }
+};
+
+struct Client
+{
+    std::shared_ptr<SocketConnection> connection;
+    std::vector<uint8_t> buffer;
+    // Cleared once the client disconnected or sent a malformed request
+    bool reading = true;
+};
+
+static bool SetNonBlocking(int fd)
+{
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+static int ListenUnix(const std::string &path)
+{
+    sockaddr_un address = {};
+    if (path.size() >= sizeof(address.sun_path))
+        return -1;
+    address.sun_family = AF_UNIX;
+    std::strcpy(address.sun_path, path.c_str());
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(path.c_str());
+    if (fd < 0 || bind(fd, (sockaddr *)&address, sizeof(address)) != 0 || listen(fd, SOMAXCONN) != 0)
+    {
+        if (fd >= 0)
+            close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/**
+ * @brief Listens on a TCP port of the loopback interface only, the protocol has no authentication.
+ *
+ */
+static int ListenTcp(int port)
+{
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    int reuse = 1;
+    if (fd < 0 || setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) != 0 ||
+        bind(fd, (sockaddr *)&address, sizeof(address)) != 0 || listen(fd, SOMAXCONN) != 0)
+    {
+        if (fd >= 0)
+            close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/**
+ * @brief Reads what the client sent and submits every complete request.
+ *
+ * @return true The client is still connected.
+ * @return false The client disconnected or sent a malformed request.
+ */
+static bool ReadClient(GameServer &server, Client &client)
+{
+    uint8_t data[SERVER_READ_SIZE];
+    while (true)
+    {
+        ssize_t received = recv(client.connection->Fd(), data, sizeof(data), 0);
+        if (received == 0)
+            return false;
+        if (received < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+                return false;
+            break;
+        }
+        client.buffer.insert(client.buffer.end(), data, data + received);
+    }
+
+    size_t offset = 0;
+    RequestHeader header;
+    while (ReadRequestHeader(client.buffer.data() + offset, client.buffer.size() - offset, &header))
+    {
+        if (header.size < SERVER_REQUEST_HEADER_SIZE || header.size > SERVER_MAX_REQUEST_SIZE)
+            return false;
+        if (client.buffer.size() - offset < header.size)
+            break;
+        if (!server.Submit(client.buffer.data() + offset, header.size, client.connection))
+            return false;
+        offset += header.size;
+    }
+    client.buffer.erase(client.buffer.begin(), client.buffer.begin() + offset);
+    return true;
+}
+
+/**
+ * @brief Hosts games for bots over a local socket, see `server_protocol.h` for the protocol.
+ * minisweeper_server [--unix <path> | --tcp <port>] [--threads <n>]
+ *
+ */
+int main(int argc, char **argv)
+{
+    std::string socket_path = SERVER_DEFAULT_SOCKET;
+    int port = 0;
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--unix") == 0 && i + 1 < argc)
+            socket_path = argv[++i];
+        else if (strcmp(argv[i], "--tcp") == 0 && i + 1 < argc)
+            port = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            threads = atoi(argv[++i]);
+        else
+        {
+            fprintf(stderr, "Usage: %s [--unix <path> | --tcp <port>] [--threads <n>]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    int listener = port > 0 ? ListenTcp(port) : ListenUnix(socket_path);
+    if (listener < 0 || !SetNonBlocking(listener))
+    {
+        fprintf(stderr, "Unable to listen on %s: %s\n", port > 0 ? ("port " + std::to_string(port)).c_str() : socket_path.c_str(), strerror(errno));
+        return 1;
+    }
+
+    signal(SIGINT, RequestStop);
+    signal(SIGTERM, RequestStop);
+    printf("Listening on %s with %d worker threads\n", port > 0 ? ("127.0.0.1:" + std::to_string(port)).c_str() : socket_path.c_str(), threads);
+    fflush(stdout);
+
+    // The workers write to the pipe when a response waits for a writable socket
+    int wake_pipe[2];
+    if (pipe(wake_pipe) != 0 || !SetNonBlocking(wake_pipe[0]) || !SetNonBlocking(wake_pipe[1]))
+    {
+        fprintf(stderr, "Unable to create a pipe: %s\n", strerror(errno));
+        return 1;
+    }
+
+    GameServer server(threads);
+    std::vector<Client> clients;
+    std::vector<pollfd> fds;
+
+    while (!stop_requested)
+    {
+        // The listener and the pipe first, then one entry per client in the order of `clients`
+        fds.clear();
+        fds.push_back(pollfd{listener, POLLIN, 0});
+        fds.push_back(pollfd{wake_pipe[0], POLLIN, 0});
+        for (const Client &client : clients)
+        {
+            short events = (client.reading ? POLLIN : 0) | (client.connection->Pending() ? POLLOUT : 0);
+            fds.push_back(pollfd{events ? client.connection->Fd() : -1, events, 0});
+        }
+
+        if (poll(fds.data(), fds.size(), 200) < 0)
+            continue;
+
+        uint8_t wake_bytes[64];
+        while (read(wake_pipe[0], wake_bytes, sizeof(wake_bytes)) > 0)
+        {
+        }
+
+        for (size_t i = clients.size(); i > 0; i--)
+        {
+            Client &client = clients[i - 1];
+            short revents = fds[i + 1].revents;
+            if (revents & POLLOUT)
+                client.connection->Flush();
+
+            if (client.reading && (client.connection->Failed() || ((revents & ~POLLOUT) != 0 && !ReadClient(server, client))))
+            {
+                shutdown(client.connection->Fd(), SHUT_RD);
+                client.reading = false;
+                server.CloseGames(client.connection.get());
+            }
+
+            // Closed once the requests still queued are answered and sent
+            if (!client.reading && client.connection.use_count() == 1 && !client.connection->Pending())
+                clients.erase(clients.begin() + (i - 1));
+        }
+
+        if (fds[0].revents & POLLIN)
+        {
+            int fd;
+            while ((fd = accept(listener, nullptr, nullptr)) >= 0)
+            {
+                int no_delay = 1;
+                if (port > 0)
+                    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
+                SetNonBlocking(fd);
+                clients.push_back(Client{std::make_shared<SocketConnection>(fd, wake_pipe[1]), {}});
+            }
+        }
+    }
+
+    ServerStats stats = server.Stats();
+    printf("%ld games open, %ld moves, %ld steals\n", stats.games, stats.moves, stats.steals);
+    // The pipe stays open, the server still answers the queued requests when it goes out of scope
+    close(listener);
+    if (port == 0)
+        unlink(socket_path.c_str());
+    return 0;
+}
@@ -0,0 +1,203 @@
+#ifndef SERVER_PROTOCOL_H
+#define SERVER_PROTOCOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include "board.h"
+
+// Every message starts with a header, all numbers are little endian:
+// request:  u32 size (whole message), u8 type, u8[3] reserved, u32 request id, u32 game id
+// response: u32 size (whole message), u8 type, u8 status, u8[2] reserved, u32 request id
+#define SERVER_REQUEST_HEADER_SIZE 16
+#define SERVER_RESPONSE_HEADER_SIZE 12
+#define SERVER_MAX_REQUEST_SIZE 64
+#define SERVER_MAX_BOARD_SIZE 4096
+#define SERVER_MAX_DELTA_CELLS 65536
+
+namespace minis
+{
+    /**
+     * @brief Request types and their payload. The response has the same type.
+     *
+     */
+    enum class ServerMessage : uint8_t
+    {
+        // u16 rows, u16 columns, u32 mines, u64 seed (0 picks one)
+        // -> u32 game id, u16 rows, u16 columns, u32 mines
+        NewGame = 1,
+        // u16 row, u16 column -> u8 RevealResult, u8 ServerGameState, u32 opened cells, u32 version
+        Reveal,
+        // u16 row, u16 column -> u8 toggled, u8 flagged, u32 version
+        Flag,
+        // u32 version -> u8 ServerGameState, u32 version, u32 count, count x (u32 cell, u8 ServerCellBits)
+        QueryDelta,
+        // (empty) -> (empty)
+        CloseGame,
+    };
+
+    enum class ServerStatus : uint8_t
+    {
+        Ok = 0,
+        BadRequest,
+        // Also for games of other connections, a game belongs to the connection which started it
+        UnknownGame,
+    };
+
+    enum class ServerGameState : uint8_t
+    {
+        Playing = 0,
+        Won,
+        Lost,
+    };
+
+    /**
+     * @brief What a client may know about a cell: mines and numbers only show once the cell is
+     * revealed.
+     *
+     */
+    enum ServerCellBits : uint8_t
+    {
+        SERVER_CELL_REVEALED = 1 << 0,
+        SERVER_CELL_FLAGGED = 1 << 1,
+        SERVER_CELL_MINE = 1 << 2,
+        SERVER_CELL_TRIGGERED = 1 << 3,
+        SERVER_CELL_COUNT_SHIFT = 4,
+    };
+
+    struct RequestHeader
+    {
+        uint32_t size;
+        ServerMessage type;
+        uint32_t request_id;
+        uint32_t game_id;
+    };
+
+    struct ResponseHeader
+    {
+        uint32_t size;
+        ServerMessage type;
+        ServerStatus status;
+        uint32_t request_id;
+    };
+
+    inline void PutLittleEndian(uint8_t *out, uint64_t value, int bytes)
+    {
+        for (int i = 0; i < bytes; i++)
+            out[i] = (uint8_t)(value >> (8 * i));
+    }
+
+    inline uint64_t GetLittleEndian(const uint8_t *data, int bytes)
+    {
+        uint64_t value = 0;
+        for (int i = 0; i < bytes; i++)
+            value |= (uint64_t)data[i] << (8 * i);
+        return value;
+    }
+
+    /**
+     * @brief Reads a request header.
+     *
+     * @param data Received bytes.
+     * @param size Number of received bytes.
+     * @param header Receives the header.
+     * @return true The header is complete, the message is complete once `size` bytes arrived.
+     * @return false Not enough bytes yet.
+     */
+    inline bool ReadRequestHeader(const uint8_t *data, size_t size, RequestHeader *header)
+    {
+        if (size < SERVER_REQUEST_HEADER_SIZE)
+            return false;
+        header->size = (uint32_t)GetLittleEndian(data, 4);
+        header->type = (ServerMessage)data[4];
+        header->request_id = (uint32_t)GetLittleEndian(data + 8, 4);
+        header->game_id = (uint32_t)GetLittleEndian(data + 12, 4);
+        return true;
+    }
+
+    inline bool ReadResponseHeader(const uint8_t *data, size_t size, ResponseHeader *header)
+    {
+        if (size < SERVER_RESPONSE_HEADER_SIZE)
+            return false;
+        header->size = (uint32_t)GetLittleEndian(data, 4);
+        header->type = (ServerMessage)data[4];
+        header->status = (ServerStatus)data[5];
+        header->request_id = (uint32_t)GetLittleEndian(data + 8, 4);
+        return true;
+    }
+
+    /**
+     * @brief Writes a request header followed by `payload_size` bytes of room for the payload.
+     *
+     * @return size_t Size of the whole message.
+     */
+    inline size_t WriteRequestHeader(uint8_t *out, ServerMessage type, uint32_t request_id, uint32_t game_id, size_t payload_size)
+    {
+        size_t size = SERVER_REQUEST_HEADER_SIZE + payload_size;
+        PutLittleEndian(out, size, 4);
+        PutLittleEndian(out + 4, (uint8_t)type, 1);
+        PutLittleEndian(out + 5, 0, 3);
+        PutLittleEndian(out + 8, request_id, 4);
+        PutLittleEndian(out + 12, game_id, 4);
+        return size;
+    }
+
+    inline size_t WriteResponseHeader(uint8_t *out, ServerMessage type, ServerStatus status, uint32_t request_id, size_t payload_size)
+    {
+        size_t size = SERVER_RESPONSE_HEADER_SIZE + payload_size;
+        PutLittleEndian(out, size, 4);
+        PutLittleEndian(out + 4, (uint8_t)type, 1);
+        PutLittleEndian(out + 5, (uint8_t)status, 1);
+        PutLittleEndian(out + 6, 0, 2);
+        PutLittleEndian(out + 8, request_id, 4);
+        return size;
+    }
+
+    /**
+     * @brief Writes a NewGame request into `out`, which needs `SERVER_MAX_REQUEST_SIZE` bytes.
+     *
+     * @return size_t Size of the message.
+     */
+    inline size_t WriteNewGame(uint8_t *out, uint32_t request_id, int rows, int columns, int mines, uint64_t seed)
+    {
+        uint8_t *payload = out + SERVER_REQUEST_HEADER_SIZE;
+        PutLittleEndian(payload, rows, 2);
+        PutLittleEndian(payload + 2, columns, 2);
+        PutLittleEndian(payload + 4, mines, 4);
+        PutLittleEndian(payload + 8, seed, 8);
+        return WriteRequestHeader(out, ServerMessage::NewGame, request_id, 0, 16);
+    }
+
+    /**
+     * @brief Writes a Reveal or Flag request into `out`.
+     *
+     * @return size_t Size of the message.
+     */
+    inline size_t WriteMove(uint8_t *out, ServerMessage type, uint32_t request_id, uint32_t game_id, int row, int col)
+    {
+        uint8_t *payload = out + SERVER_REQUEST_HEADER_SIZE;
+        PutLittleEndian(payload, row, 2);
+        PutLittleEndian(payload + 2, col, 2);
+        return WriteRequestHeader(out, type, request_id, game_id, 4);
+    }
+
+    inline size_t WriteQueryDelta(uint8_t *out, uint32_t request_id, uint32_t game_id, uint32_t version)
+    {
+        PutLittleEndian(out + SERVER_REQUEST_HEADER_SIZE, version, 4);
+        return WriteRequestHeader(out, ServerMessage::QueryDelta, request_id, game_id, 4);
+    }
+
+    /**
+     * @brief Returns the `ServerCellBits` of a cell.
+     *
+     * @param cell Gameplay state of the cell.
+     */
+    inline uint8_t ServerCell(const Cell &cell)
+    {
+        if (cell.concealed)
+            return cell.flagged ? SERVER_CELL_FLAGGED : 0;
+        return SERVER_CELL_REVEALED | (cell.flagged ? SERVER_CELL_FLAGGED : 0) | (cell.mine ? SERVER_CELL_MINE : 0) |
+               (cell.triggered ? SERVER_CELL_TRIGGERED : 0) | (cell.neighbor_mines << SERVER_CELL_COUNT_SHIFT);
+    }
+}
+
+#endif
@@ -0,0 +1,242 @@
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "game_server.h"
+
+using namespace ::minis;
+
+#define RESPONSE_TIMEOUT_SECONDS 30
+
+static int failed = 0;
+
+static void Check(bool condition, const char *what)
+{
+    if (condition)
+        return;
+    printf("FAILED: %s\n", what);
+    failed++;
+}
+
+/**
+ * @brief Client of the server in process: keeps every response until the test asks for it.
+ *
+ */
+class TestClient : public ServerConnection
+{
+public:
+    explicit TestClient(GameServer &server) : server(server) {}
+
+    void Send(const uint8_t *data, size_t size) override
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        responses.emplace_back(data, data + size);
+        arrived.notify_all();
+    }
+
+    /**
+     * @brief Submits a request and waits for its response.
+     *
+     * @param size Size of the request in `message`.
+     * @param payload Receives the payload of the response.
+     * @return ServerStatus Status of the response, `BadRequest` if none arrived in time.
+     */
+    ServerStatus Request(size_t size, std::vector<uint8_t> *payload = nullptr)
+    {
+        uint32_t request_id = (uint32_t)GetLittleEndian(message + 8, 4);
+        if (!server.Submit(message, size, self))
+            return ServerStatus::BadRequest;
+
+        std::unique_lock<std::mutex> lock(mutex);
+        std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::seconds(RESPONSE_TIMEOUT_SECONDS);
+        while (true)
+        {
+            for (size_t i = 0; i < responses.size(); i++)
+            {
+                ResponseHeader header;
+                if (!ReadResponseHeader(responses[i].data(), responses[i].size(), &header) || header.request_id != request_id)
+                    continue;
+
+                if (payload)
+                    payload->assign(responses[i].begin() + SERVER_RESPONSE_HEADER_SIZE, responses[i].end());
+                responses.erase(responses.begin() + i);
+                return header.status;
+            }
+            if (arrived.wait_until(lock, deadline) == std::cv_status::timeout)
+            {
+                printf("no response to request %u\n", request_id);
+                return ServerStatus::BadRequest;
+            }
+        }
+    }
+
+    /**
+     * @brief Starts a game and returns its id, 0 if the server refused it.
+     *
+     */
+    uint32_t NewGame(int rows, int columns, int mines, uint64_t seed)
+    {
+        std::vector<uint8_t> payload;
+        if (Request(WriteNewGame(message, next_request++, rows, columns, mines, seed), &payload) != ServerStatus::Ok)
+            return 0;
+        return (uint32_t)GetLittleEndian(payload.data(), 4);
+    }
+
+    std::shared_ptr<TestClient> self;
+    uint8_t message[SERVER_MAX_REQUEST_SIZE];
+    uint32_t next_request = 1;
+
+private:
+    GameServer &server;
+    std::mutex mutex;
+    std::condition_variable arrived;
+    std::vector<std::vector<uint8_t>> responses;
+};
+
+static std::shared_ptr<TestClient> Connect(GameServer &server)
+{
+    std::shared_ptr<TestClient> client = std::make_shared<TestClient>(server);
+    client->self = client;
+    return client;
+}
+
+static void TestBadRequests(GameServer &server)
+{
+    std::shared_ptr<TestClient> client = Connect(server);
+    uint8_t *message = client->message;
+
+    // Malformed messages close the connection
+    size_t size = WriteNewGame(message, client->next_request++, 9, 9, 10, 1);
+    Check(!server.Submit(message, size - 1, client), "a message shorter than its header says is malformed");
+    PutLittleEndian(message, SERVER_MAX_REQUEST_SIZE + 1, 4);
+    Check(!server.Submit(message, SERVER_MAX_REQUEST_SIZE + 1, client), "a message over the size limit is malformed");
+
+    // Bad sizes are refused without starting a game
+    long games = server.Stats().games;
+    Check(client->NewGame(0, 9, 1, 1) == 0, "a board without rows is refused");
+    Check(client->NewGame(9, SERVER_MAX_BOARD_SIZE + 1, 1, 1) == 0, "a board over the size limit is refused");
+    Check(client->NewGame(3, 3, 9, 1) == 0, "a board full of mines is refused");
+    size = WriteNewGame(message, client->next_request++, 9, 9, 10, 1);
+    PutLittleEndian(message, size - 4, 4);
+    Check(client->Request(size - 4) == ServerStatus::BadRequest, "a short NewGame payload is refused");
+    Check(server.Stats().games == games, "refused games are not kept");
+
+    uint32_t game = client->NewGame(9, 9, 10, 1);
+    Check(game != 0, "a valid game starts");
+    Check(client->Request(WriteMove(message, ServerMessage::Reveal, client->next_request++, game, 9, 0)) == ServerStatus::BadRequest,
+          "a reveal outside the board is refused");
+    Check(client->Request(WriteMove(message, ServerMessage::Flag, client->next_request++, game, 0, 9)) == ServerStatus::BadRequest,
+          "a flag outside the board is refused");
+    Check(client->Request(WriteQueryDelta(message, client->next_request++, game, 1)) == ServerStatus::BadRequest,
+          "a delta from a version the game has not reached is refused");
+    Check(client->Request(WriteRequestHeader(message, (ServerMessage)99, client->next_request++, game, 0)) == ServerStatus::BadRequest,
+          "an unknown message type is refused");
+    Check(client->Request(WriteMove(message, ServerMessage::Reveal, client->next_request++, game + 1000, 0, 0)) == ServerStatus::UnknownGame,
+          "a move in an unknown game is refused");
+
+    // Games belong to the connection which started them
+    std::shared_ptr<TestClient> other = Connect(server);
+    Check(other->Request(WriteMove(other->message, ServerMessage::Reveal, other->next_request++, game, 0, 0)) == ServerStatus::UnknownGame,
+          "a move in the game of another connection is refused");
+    Check(client->Request(WriteMove(message, ServerMessage::Reveal, client->next_request++, game, 4, 4)) == ServerStatus::Ok,
+          "the game is still playable by its connection");
+
+    Check(client->Request(WriteRequestHeader(message, ServerMessage::CloseGame, client->next_request++, game, 0)) == ServerStatus::Ok,
+          "a game closes");
+    Check(client->Request(WriteQueryDelta(message, client->next_request++, game, 0)) == ServerStatus::UnknownGame,
+          "a closed game is gone");
+}
+
+/**
+ * @brief Opens nearly all of a large board with the first click, which takes several pages of
+ * `SERVER_MAX_DELTA_CELLS`, and follows the pages up to the version of the reveal.
+ *
+ */
+static void TestDeltaPaging(GameServer &server)
+{
+    std::shared_ptr<TestClient> client = Connect(server);
+    uint8_t *message = client->message;
+    int rows = 512, columns = 512;
+    uint32_t game = client->NewGame(rows, columns, 8, 5);
+    Check(game != 0, "a large game starts");
+
+    std::vector<uint8_t> payload;
+    if (client->Request(WriteMove(message, ServerMessage::Reveal, client->next_request++, game, rows / 2, columns / 2), &payload) != ServerStatus::Ok)
+    {
+        Check(false, "the first reveal of the large game is answered");
+        return;
+    }
+    uint32_t opened = (uint32_t)GetLittleEndian(payload.data() + 2, 4);
+    uint32_t latest = (uint32_t)GetLittleEndian(payload.data() + 6, 4);
+    Check(opened > 2 * SERVER_MAX_DELTA_CELLS, "the first reveal opens more than two pages");
+
+    std::vector<uint8_t> cells(rows * columns, 0);
+    uint32_t version = 0;
+    int pages = 0;
+    while (version < latest)
+    {
+        if (client->Request(WriteQueryDelta(message, client->next_request++, game, version), &payload) != ServerStatus::Ok)
+        {
+            Check(false, "every page is answered");
+            return;
+        }
+        uint32_t next = (uint32_t)GetLittleEndian(payload.data() + 1, 4);
+        uint32_t count = (uint32_t)GetLittleEndian(payload.data() + 5, 4);
+        Check(count == std::min<uint32_t>(latest - version, SERVER_MAX_DELTA_CELLS) && next == version + count && payload.size() == 9 + count * 5,
+              "a page holds as many cells as fit and continues where the last one ended");
+        for (uint32_t i = 0; i < count; i++)
+        {
+            uint32_t cell = (uint32_t)GetLittleEndian(payload.data() + 9 + i * 5, 4);
+            if (cell < cells.size())
+                cells[cell] = payload[9 + i * 5 + 4];
+        }
+        version = next;
+        pages++;
+    }
+    Check(pages > 2, "the delta takes several pages");
+
+    // A won game shows its mines as well
+    uint32_t revealed = 0;
+    for (uint8_t cell : cells)
+        revealed += (cell & SERVER_CELL_REVEALED) && !(cell & SERVER_CELL_MINE);
+    Check(revealed == opened, "the pages hold every opened cell");
+
+    Check(client->Request(WriteQueryDelta(message, client->next_request++, game, latest), &payload) == ServerStatus::Ok &&
+              GetLittleEndian(payload.data() + 5, 4) == 0,
+          "the latest version has no changes left");
+}
+
+static void TestDisconnect(GameServer &server)
+{
+    std::shared_ptr<TestClient> client = Connect(server);
+    long games = server.Stats().games;
+    uint32_t game = 0;
+    for (int i = 0; i < 3; i++)
+        game = client->NewGame(16, 30, 99, i + 1);
+    Check(server.Stats().games == games + 3, "the games of a connection are kept");
+
+    server.CloseGames(client.get());
+    Check(server.Stats().games == games, "the games of a disconnected client are closed");
+    Check(client->Request(WriteQueryDelta(client->message, client->next_request++, game, 0)) == ServerStatus::UnknownGame,
+          "the games of a disconnected client are gone");
+}
+
+/**
+ * @brief Checks the protocol of `GameServer` in process: refused requests, ownership of games,
+ * paging of large deltas and closing the games of a client which went away.
+ *
+ */
+int main()
+{
+    {
+        GameServer server(2);
+        TestBadRequests(server);
+        TestDeltaPaging(server);
+        TestDisconnect(server);
+    }
+
+    printf("%d checks failed\n", failed);
+    return failed > 0 ? 1 : 0;
+}
@@ -2,11 +2,14 @@
 #define SETTINGS_H
 
 #include <string>
-#include <raylib.h>
-#include "defines.h"
+#include <algorithm>
 
 #define TILE_SIZE_SMALL 31
 #define TILE_SIZE_BIG 51
+#define FONT_SIZE_SMALL 25
+#define FONT_SIZE_BIG 45
+#define CUSTOM_MIN_SIZE 5
+#define CUSTOM_MAX_SIZE 1000
 
 namespace minis
 {
@@ -16,7 +19,9 @@ namespace minis
                                   "Intermediate (13 x 15, 40);"
                                   "Intermediate (16 x 16, 40);"
                                   "Expert (16 x 30, 99);"
-                                  "Expert (30 x 16, 99)";
+                                  "Expert (30 x 16, 99);"
+                                  "Custom;"
+                                  "Marathon";
 
     enum DifficultyLevel
     {
@@ -27,6 +32,7 @@ namespace minis
         INTERMEDIATE_2,
         EXPERT_1,
         EXPERT_2,
+        DIFFICULTY_LEVEL_COUNT,
     };
 
     struct GameSettings
@@ -49,19 +55,19 @@ namespace minis
         switch (level)
         {
         case BEGINNER_1:
-            return GameSettings{8, 8, 10, TILE_SIZE_BIG, 45};
+            return GameSettings{8, 8, 10, TILE_SIZE_BIG, FONT_SIZE_BIG};
         case BEGINNER_2:
-            return GameSettings{9, 9, 10, TILE_SIZE_BIG, 45};
+            return GameSettings{9, 9, 10, TILE_SIZE_BIG, FONT_SIZE_BIG};
         case BEGINNER_3:
-            return GameSettings{10, 10, 10, TILE_SIZE_BIG, 45};
+            return GameSettings{10, 10, 10, TILE_SIZE_BIG, FONT_SIZE_BIG};
         case INTERMEDIATE_1:
-            return GameSettings{13, 15, 40, TILE_SIZE_BIG, 45};
+            return GameSettings{13, 15, 40, TILE_SIZE_BIG, FONT_SIZE_BIG};
         case INTERMEDIATE_2:
-            return GameSettings{16, 16, 40, TILE_SIZE_BIG, 45};
+            return GameSettings{16, 16, 40, TILE_SIZE_BIG, FONT_SIZE_BIG};
         case EXPERT_1:
-            return GameSettings{16, 30, 99, TILE_SIZE_SMALL, 25};
+            return GameSettings{16, 30, 99, TILE_SIZE_SMALL, FONT_SIZE_SMALL};
         case EXPERT_2:
-            return GameSettings{30, 16, 99, TILE_SIZE_SMALL, 25};
+            return GameSettings{30, 16, 99, TILE_SIZE_SMALL, FONT_SIZE_SMALL};
 
         default:
             return GameSettings{8, 8, 10, TILE_SIZE_BIG};
@@ -69,16 +75,32 @@ namespace minis
     }
 
     /**
-     * @brief Calculates the window size according to the amount of rows, columns and the cell size.
-     * 
-     * @param settings GameSetting containing the field setup information
-     * @return Vector2 Window width and height based on the field size.
+     * @brief Checks if a tile and font size are one of the pairs the game has sprites for, i. e.
+     * settings read from a file.
+     *
+     */
+    inline bool ValidTileSize(int tile_size, int font_size)
+    {
+        return (tile_size == TILE_SIZE_SMALL && font_size == FONT_SIZE_SMALL) ||
+               (tile_size == TILE_SIZE_BIG && font_size == FONT_SIZE_BIG);
+    }
+
+    /**
+     * @brief Returns the GameSettings of a custom board size with small tiles. The size is
+     * limited to `CUSTOM_MIN_SIZE` to `CUSTOM_MAX_SIZE` and at least the first click and its
+     * neighbours stay free of mines.
+     *
+     * @param rows Desired number of rows.
+     * @param columns Desired number of columns.
+     * @param mines Desired number of mines.
+     * @return GameSettings Settings of the limited size.
      */
-    inline Vector2 GetWindowSize(const GameSettings *settings)
+    inline GameSettings GetCustomSettings(int rows, int columns, int mines)
     {
-        float width = settings->tile_size * settings->columns;
-        float height = settings->tile_size * settings->rows + HEADER_HEIGHT;
-        return Vector2{width, height};
+        rows = std::max(CUSTOM_MIN_SIZE, std::min(rows, CUSTOM_MAX_SIZE));
+        columns = std::max(CUSTOM_MIN_SIZE, std::min(columns, CUSTOM_MAX_SIZE));
+        mines = std::max(1, std::min(mines, rows * columns - 9));
+        return GameSettings{rows, columns, mines, TILE_SIZE_SMALL, FONT_SIZE_SMALL};
     }
 
 }
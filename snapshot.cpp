@@ -0,0 +1,388 @@
+#include "snapshot.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#ifdef MINIS_SNAPSHOT_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#endif
+
+namespace minis
+{
+    namespace
+    {
+        const char MAGIC[4] = {'M', 'S', 'S', 'V'};
+        const uint32_t VERSION = 1;
+
+        /**
+         * @brief Snapshot header, stored in host byte order at the start of the file.
+         *
+         */
+        struct SnapshotHeader
+        {
+            char magic[4];
+            uint32_t version;
+            uint32_t rows;
+            uint32_t columns;
+            uint32_t mines;
+            uint32_t tile_size;
+            uint32_t font_size;
+            uint32_t open_count;
+            uint32_t flag_count;
+            int32_t triggered;
+            uint64_t seed;
+            uint64_t elapsed_ms;
+        };
+        static_assert(sizeof(SnapshotHeader) <= SNAPSHOT_HEADER_SIZE, "Snapshot header does not fit");
+
+        inline uint8_t PackCell(const Cell &cell)
+        {
+            return (cell.mine ? SNAPSHOT_MINE : 0) | (cell.concealed ? 0 : SNAPSHOT_REVEALED) |
+                   (cell.flagged ? SNAPSHOT_FLAGGED : 0) | (cell.triggered ? SNAPSHOT_TRIGGERED : 0) |
+                   (cell.neighbor_mines << SNAPSHOT_COUNT_SHIFT);
+        }
+
+        size_t FileSize(int rows, int columns)
+        {
+            return SNAPSHOT_HEADER_SIZE + (size_t)rows * columns;
+        }
+
+#ifdef MINIS_SNAPSHOT_MMAP
+        size_t PageSize()
+        {
+            return (size_t)sysconf(_SC_PAGESIZE);
+        }
+
+        /**
+         * @brief Creates a file of `size` bytes and maps it for writing.
+         *
+         * @return uint8_t* The mapping, `nullptr` if the file could not be created.
+         */
+        uint8_t *MapForWriting(const std::string &path, size_t size, int *file)
+        {
+            *file = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+            if (*file < 0)
+                return nullptr;
+
+            void *mapping = ftruncate(*file, size) == 0 ? mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, *file, 0) : MAP_FAILED;
+            if (mapping == MAP_FAILED)
+            {
+                close(*file);
+                *file = -1;
+                return nullptr;
+            }
+            return (uint8_t *)mapping;
+        }
+
+        void Unmap(int file, uint8_t *data, size_t size)
+        {
+            if (data)
+                munmap(data, size);
+            if (file >= 0)
+                close(file);
+        }
+
+        /**
+         * @brief Schedules the write back of a range of the mapping without waiting for the disk,
+         * saves run on the UI thread. The pages are in the page cache already, so the snapshot
+         * survives a crash of the game, only a crash of the system may lose the last save.
+         *
+         */
+        bool Sync(const std::string &, uint8_t *data, size_t begin, size_t end)
+        {
+            return msync(data + begin, end - begin, MS_ASYNC) == 0;
+        }
+
+        /**
+         * @brief Maps a whole file for reading.
+         *
+         * @return const uint8_t* The mapping, `nullptr` if the file could not be read.
+         */
+        const uint8_t *MapForReading(const std::string &path, size_t *size)
+        {
+            int file = open(path.c_str(), O_RDONLY);
+            if (file < 0)
+                return nullptr;
+
+            struct stat info;
+            void *mapping = MAP_FAILED;
+            if (fstat(file, &info) == 0 && info.st_size > 0)
+            {
+                *size = (size_t)info.st_size;
+                mapping = mmap(nullptr, *size, PROT_READ, MAP_PRIVATE, file, 0);
+            }
+            close(file);
+            if (mapping == MAP_FAILED)
+                return nullptr;
+
+            madvise(mapping, *size, MADV_SEQUENTIAL);
+            return (const uint8_t *)mapping;
+        }
+
+        void UnmapReading(const uint8_t *data, size_t size)
+        {
+            munmap((void *)data, size);
+        }
+#else
+        // Without mmap the "mapping" is a buffer, the dirty ranges are written to the file on sync
+        size_t PageSize()
+        {
+            return 4096;
+        }
+
+        uint8_t *MapForWriting(const std::string &path, size_t size, int *file)
+        {
+            *file = -1;
+            std::ofstream create(path, std::ios::binary | std::ios::trunc);
+            return create ? new uint8_t[size]() : nullptr;
+        }
+
+        void Unmap(int, uint8_t *data, size_t)
+        {
+            delete[] data;
+        }
+
+        bool Sync(const std::string &path, uint8_t *data, size_t begin, size_t end)
+        {
+            std::fstream out(path, std::ios::in | std::ios::out | std::ios::binary);
+            out.seekp(begin);
+            out.write((const char *)data + begin, end - begin);
+            return (bool)out.flush();
+        }
+
+        const uint8_t *MapForReading(const std::string &path, size_t *size)
+        {
+            std::ifstream in(path, std::ios::binary | std::ios::ate);
+            if (!in || in.tellg() <= 0)
+                return nullptr;
+
+            *size = (size_t)in.tellg();
+            uint8_t *data = new uint8_t[*size];
+            in.seekg(0);
+            if (!in.read((char *)data, *size))
+            {
+                delete[] data;
+                return nullptr;
+            }
+            return data;
+        }
+
+        void UnmapReading(const uint8_t *data, size_t)
+        {
+            delete[] data;
+        }
+#endif
+    }
+
+    SnapshotWriter::SnapshotWriter(const std::string &path)
+        : path(path)
+    {
+    }
+
+    SnapshotWriter::~SnapshotWriter()
+    {
+        Close();
+    }
+
+    void SnapshotWriter::Close()
+    {
+        Unmap(file, data, size);
+        data = nullptr;
+        file = -1;
+        size = 0;
+    }
+
+    /**
+     * @brief (Re)creates the file in the size of the board and maps it.
+     *
+     * @param board Board to be saved.
+     * @return true The file is mapped.
+     * @return false The file could not be created.
+     */
+    bool SnapshotWriter::Create(const Board &board)
+    {
+        Close();
+        rows = board.Rows();
+        columns = board.Columns();
+        size = FileSize(rows, columns);
+
+        data = MapForWriting(path, size, &file);
+        if (!data)
+        {
+            Close();
+            return false;
+        }
+
+        for (auto &plane : saved)
+            plane.clear();
+        return true;
+    }
+
+    bool SnapshotWriter::Save(const Board &board, const GameSettings &settings, uint64_t elapsed_ms)
+    {
+        if ((!data || board.Rows() != rows || board.Columns() != columns) && !Create(board))
+            return false;
+
+        const size_t page_size = PageSize();
+        const size_t cells = (size_t)rows * columns;
+        uint8_t *cell_bytes = data + SNAPSHOT_HEADER_SIZE;
+        const BitBoard &bits = board.Bits();
+
+        // A new layout (first save, safe first click) changes neighbor counts anywhere, rewrite everything
+        bool full = saved[BitBoard::MINE] != bits.Words(BitBoard::MINE);
+        std::vector<size_t> dirty_pages;
+
+        if (full)
+        {
+            for (size_t i = 0; i < cells; i++)
+                cell_bytes[i] = PackCell(board.At((int)(i / columns), (int)(i % columns)));
+            for (size_t page = SNAPSHOT_HEADER_SIZE / page_size; page * page_size < size; page++)
+                dirty_pages.push_back(page);
+            for (int plane = 0; plane < BitBoard::PLANE_COUNT; plane++)
+                saved[plane] = bits.Words((BitBoard::Plane)plane);
+        }
+        else
+        {
+            const std::vector<uint64_t> &revealed = bits.Words(BitBoard::REVEALED);
+            const std::vector<uint64_t> &flags = bits.Words(BitBoard::FLAG);
+
+            for (size_t w = 0; w < revealed.size(); w++)
+            {
+                if (revealed[w] == saved[BitBoard::REVEALED][w] && flags[w] == saved[BitBoard::FLAG][w])
+                    continue;
+
+                saved[BitBoard::REVEALED][w] = revealed[w];
+                saved[BitBoard::FLAG][w] = flags[w];
+                size_t end = std::min(cells, w * 64 + 64);
+                for (size_t i = w * 64; i < end; i++)
+                    cell_bytes[i] = PackCell(board.At((int)(i / columns), (int)(i % columns)));
+
+                for (size_t page = (SNAPSHOT_HEADER_SIZE + w * 64) / page_size; page <= (SNAPSHOT_HEADER_SIZE + end - 1) / page_size; page++)
+                {
+                    if (dirty_pages.empty() || dirty_pages.back() != page)
+                        dirty_pages.push_back(page);
+                }
+            }
+        }
+
+        SnapshotHeader header = {};
+        std::memcpy(header.magic, MAGIC, 4);
+        header.version = VERSION;
+        header.rows = rows;
+        header.columns = columns;
+        header.mines = board.MineCount();
+        header.tile_size = settings.tile_size;
+        header.font_size = settings.font_size;
+        header.open_count = board.OpenCount();
+        header.flag_count = board.FlagCount();
+        // Games in progress have no triggered cell, the state copy is only needed for lost ones
+        header.triggered = board.Lost() ? board.SaveState().triggered : -1;
+        header.seed = board.Seed();
+        header.elapsed_ms = elapsed_ms;
+        std::memcpy(data, &header, sizeof(header));
+        dirty_pages.insert(dirty_pages.begin(), 0);
+
+        // Sync runs of consecutive dirty pages
+        bool synced = true;
+        for (size_t first = 0; first < dirty_pages.size();)
+        {
+            size_t last = first;
+            while (last + 1 < dirty_pages.size() && dirty_pages[last + 1] == dirty_pages[last] + 1)
+                last++;
+
+            size_t begin = dirty_pages[first] * page_size;
+            size_t end = std::min(size, (dirty_pages[last] + 1) * page_size);
+            synced = Sync(path, data, begin, end) && synced;
+            first = last + 1;
+        }
+
+        pages_written = (int)dirty_pages.size();
+        return synced;
+    }
+
+    void SnapshotWriter::Discard()
+    {
+        Close();
+        for (auto &plane : saved)
+            plane.clear();
+        std::remove(path.c_str());
+    }
+
+    bool LoadSnapshot(const std::string &path, Board *board, GameSettings *settings, uint64_t *elapsed_ms)
+    {
+        size_t size = 0;
+        const uint8_t *data = MapForReading(path, &size);
+        if (!data)
+            return false;
+        if (size < SNAPSHOT_HEADER_SIZE)
+        {
+            UnmapReading(data, size);
+            return false;
+        }
+
+        SnapshotHeader header;
+        std::memcpy(&header, data, sizeof(header));
+
+        bool valid = std::equal(MAGIC, MAGIC + 4, header.magic) && header.version == VERSION &&
+                     header.rows > 0 && header.columns > 0 &&
+                     header.rows <= CUSTOM_MAX_SIZE && header.columns <= CUSTOM_MAX_SIZE &&
+                     ValidTileSize((int)header.tile_size, (int)header.font_size) &&
+                     size >= FileSize(header.rows, header.columns);
+
+        if (valid)
+        {
+            size_t cells = (size_t)header.rows * header.columns;
+            size_t words = (cells + 63) / 64;
+            const uint8_t *cell_bytes = data + SNAPSHOT_HEADER_SIZE;
+            std::vector<uint64_t> mines(words);
+            BoardState state;
+            state.revealed.resize(words);
+            state.flags.resize(words);
+            state.open_count = header.open_count;
+            state.triggered = header.triggered;
+            // Cells opened by the player, the end of a game reveals mines and flags without counting them
+            uint64_t mine_count = 0, open_count = 0, flag_count = 0;
+
+            for (size_t w = 0; w < words; w++)
+            {
+                uint64_t mine = 0, revealed = 0, flag = 0;
+                size_t count = std::min<size_t>(64, cells - w * 64);
+                const uint8_t *word_cells = cell_bytes + w * 64;
+                for (size_t bit = 0; bit < count; bit++)
+                {
+                    uint64_t cell = word_cells[bit];
+                    mine |= (cell & SNAPSHOT_MINE) << bit;
+                    revealed |= ((cell & SNAPSHOT_REVEALED) >> 1) << bit;
+                    flag |= ((cell & SNAPSHOT_FLAGGED) >> 2) << bit;
+                }
+                mines[w] = mine;
+                state.revealed[w] = revealed;
+                state.flags[w] = flag;
+                mine_count += __builtin_popcountll(mine);
+                open_count += __builtin_popcountll(revealed & ~mine & ~flag);
+                flag_count += __builtin_popcountll(flag);
+            }
+
+            // A header which does not match the cells would corrupt the counts of the restored game
+            bool triggered_mine = header.triggered >= 0 && (size_t)header.triggered < cells &&
+                                  (cell_bytes[header.triggered] & SNAPSHOT_MINE);
+            valid = mine_count == header.mines && mine_count < cells && open_count == header.open_count &&
+                    flag_count == header.flag_count && (header.triggered == -1 || triggered_mine);
+
+            if (valid)
+            {
+                *board = Board(header.rows, header.columns, mines, header.seed);
+                board->RestoreState(state);
+                *settings = GameSettings{(int)header.rows, (int)header.columns, (int)header.mines, (int)header.tile_size, (int)header.font_size};
+                *elapsed_ms = header.elapsed_ms;
+            }
+        }
+
+        UnmapReading(data, size);
+        return valid;
+    }
+}
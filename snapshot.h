@@ -0,0 +1,106 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+#include "board.h"
+#include "settings.h"
+
+#define SNAPSHOT_HEADER_SIZE 4096
+
+namespace minis
+{
+    /**
+     * @brief Per cell byte of a snapshot: mine, revealed, flagged and triggered bit and the
+     * neighbor count in the upper four bits.
+     *
+     */
+    enum SnapshotCellBits : uint8_t
+    {
+        SNAPSHOT_MINE = 1 << 0,
+        SNAPSHOT_REVEALED = 1 << 1,
+        SNAPSHOT_FLAGGED = 1 << 2,
+        SNAPSHOT_TRIGGERED = 1 << 3,
+        SNAPSHOT_COUNT_SHIFT = 4,
+    };
+
+    /**
+     * @brief Writes a game in progress to a memory mapped snapshot file (a buffer written with
+     * stdio where mmap is not available, see `MINIS_SNAPSHOT_MMAP`).
+     * The file holds a `SNAPSHOT_HEADER_SIZE` byte header (magic "MSSV", version, settings, open
+     * and flag count, triggered cell, seed and elapsed time) followed by one byte per cell.
+     * The first save writes the whole file, later saves compare the bit planes of the board with
+     * the previous save and only rewrite the pages of cells which changed. Their write back is
+     * scheduled (`MS_ASYNC`), a save never waits for the disk.
+     *
+     */
+    class SnapshotWriter
+    {
+    public:
+        /**
+         * @brief Construct a new SnapshotWriter object, the file is created on the first save.
+         *
+         * @param path Path of the snapshot file.
+         */
+        explicit SnapshotWriter(const std::string &path);
+        ~SnapshotWriter();
+
+        SnapshotWriter(const SnapshotWriter &) = delete;
+        SnapshotWriter &operator=(const SnapshotWriter &) = delete;
+
+        /**
+         * @brief Saves a board.
+         *
+         * @param board Board to save.
+         * @param settings Settings of the game.
+         * @param elapsed_ms Time played so far.
+         * @return true The snapshot was written.
+         * @return false The file could not be created or written.
+         */
+        bool Save(const Board &board, const GameSettings &settings, uint64_t elapsed_ms);
+
+        /**
+         * @brief Deletes the snapshot file, i. e. after the game ended.
+         *
+         */
+        void Discard();
+
+        /**
+         * @brief Returns the number of pages the last save wrote (header included).
+         *
+         */
+        inline int PagesWritten() const { return pages_written; }
+
+    private:
+        std::string path;
+        int file = -1;
+        uint8_t *data = nullptr;
+        size_t size = 0;
+        int rows = 0;
+        int columns = 0;
+        int pages_written = 0;
+        std::vector<uint64_t> saved[BitBoard::PLANE_COUNT];
+
+        bool Create(const Board &board);
+        void Close();
+    };
+
+    /**
+     * @brief Resumes a game from a snapshot file. The file is mapped and its cells are unpacked in
+     * one pass, nothing is parsed. The mine, open and flag counts of the header have to match the
+     * cells, the size has to be within `CUSTOM_MAX_SIZE` and the tile and font size one of the
+     * pairs of settings.h. The board keeps the seed of the saved game.
+     *
+     * @param path Path of the snapshot file.
+     * @param board Receives the board.
+     * @param settings Receives the settings of the game.
+     * @param elapsed_ms Receives the time played so far.
+     * @return true The game was restored.
+     * @return false There is no valid snapshot at `path`.
+     */
+    bool LoadSnapshot(const std::string &path, Board *board, GameSettings *settings, uint64_t *elapsed_ms);
+}
+
+#endif
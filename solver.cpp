@@ -0,0 +1,270 @@
+#include "solver.h"
+#include <algorithm>
+
+namespace minis
+{
+    Solver::Solver(const Board &board)
+        : board(board), rows(board.Rows()), columns(board.Columns()),
+          knowledge((size_t)board.Rows() * board.Columns(), UNKNOWN),
+          queued((size_t)board.Rows() * board.Columns(), 0)
+    {
+        Reset();
+    }
+
+    void Solver::Reset()
+    {
+        std::fill(knowledge.begin(), knowledge.end(), UNKNOWN);
+        std::fill(queued.begin(), queued.end(), 0);
+        work.clear();
+        safe_moves.clear();
+        mine_moves.clear();
+
+        // A finished game shows its mines as revealed cells, there is nothing left to deduce
+        if (board.Lost() || board.Won())
+            return;
+
+        // Every revealed cell is known, but only the numbers next to the frontier constrain anything
+        const BitBoard &bits = board.Bits();
+        const std::vector<uint64_t> &revealed = bits.Words(BitBoard::REVEALED);
+        for (size_t w = 0; w < revealed.size(); w++)
+        {
+            for (uint64_t word = revealed[w]; word; word &= word - 1)
+                knowledge[w * 64 + __builtin_ctzll(word)] = KNOWN_SAFE;
+        }
+
+        std::vector<uint64_t> frontier = bits.Frontier();
+        for (size_t w = 0; w < frontier.size(); w++)
+        {
+            for (uint64_t word = frontier[w]; word; word &= word - 1)
+                EnqueueNeighbors((int)(w * 64 + __builtin_ctzll(word)));
+        }
+        Propagate();
+    }
+
+    void Solver::Observe(const std::vector<int> &opened)
+    {
+        if (board.Lost())
+            return;
+
+        for (int index : opened)
+        {
+            knowledge[index] = KNOWN_SAFE;
+            Enqueue(index);
+            EnqueueNeighbors(index);
+        }
+
+        Propagate();
+    }
+
+    bool Solver::NextMove(SolverMove *move)
+    {
+        if (NextSafe(move))
+            return true;
+
+        while (!mine_moves.empty())
+        {
+            int index = mine_moves.back();
+            const Cell &cell = board.At(index / columns, index % columns);
+            if (cell.concealed && !cell.flagged)
+            {
+                *move = SolverMove{index / columns, index % columns, true};
+                return true;
+            }
+            mine_moves.pop_back();
+        }
+
+        return false;
+    }
+
+    bool Solver::NextSafe(SolverMove *move)
+    {
+        while (!safe_moves.empty())
+        {
+            int index = safe_moves.back();
+            const Cell &cell = board.At(index / columns, index % columns);
+            if (cell.concealed && !cell.flagged)
+            {
+                *move = SolverMove{index / columns, index % columns, false};
+                return true;
+            }
+            safe_moves.pop_back();
+        }
+
+        return false;
+    }
+
+    /**
+     * @brief Checks if a cell is a revealed number, which constrains its neighbors.
+     *
+     * @param index Flat index of the cell.
+     */
+    bool Solver::IsConstraint(int index) const
+    {
+        const Cell &cell = board.At(index / columns, index % columns);
+        return !cell.concealed && !cell.mine && cell.neighbor_mines > 0;
+    }
+
+    /**
+     * @brief Collects the unknown neighbors of a revealed number and the mines left among them.
+     *
+     * @param index Flat index of the revealed number.
+     * @param constraint Receives the constraint.
+     * @return true The constraint has at least one unknown cell.
+     * @return false The constraint is resolved.
+     */
+    bool Solver::BuildConstraint(int index, Constraint *constraint) const
+    {
+        int row = index / columns;
+        int col = index % columns;
+        constraint->count = 0;
+        constraint->mines = board.At(row, col).neighbor_mines;
+
+        for (int d_row = -1; d_row <= 1; d_row++)
+        {
+            for (int d_col = -1; d_col <= 1; d_col++)
+            {
+                if ((d_row == 0 && d_col == 0) || !board.IsValid(row + d_row, col + d_col))
+                    continue;
+
+                int neighbor = index + d_row * columns + d_col;
+                if (knowledge[neighbor] == KNOWN_MINE)
+                    constraint->mines--;
+                else if (knowledge[neighbor] == UNKNOWN)
+                    constraint->cells[constraint->count++] = neighbor;
+            }
+        }
+
+        return constraint->count > 0;
+    }
+
+    void Solver::Enqueue(int index)
+    {
+        if (queued[index] || !IsConstraint(index))
+            return;
+        queued[index] = 1;
+        work.push_back(index);
+    }
+
+    void Solver::EnqueueNeighbors(int index)
+    {
+        int row = index / columns;
+        int col = index % columns;
+
+        for (int d_row = -1; d_row <= 1; d_row++)
+        {
+            for (int d_col = -1; d_col <= 1; d_col++)
+            {
+                if ((d_row != 0 || d_col != 0) && board.IsValid(row + d_row, col + d_col))
+                    Enqueue(index + d_row * columns + d_col);
+            }
+        }
+    }
+
+    /**
+     * @brief Records a deduction and marks the constraints around the cell for re-examination.
+     *
+     * @param index Flat index of the deduced cell.
+     * @param value Deduced value.
+     */
+    void Solver::Deduce(int index, Knowledge value)
+    {
+        if (knowledge[index] != UNKNOWN)
+            return;
+
+        knowledge[index] = value;
+        if (value == KNOWN_SAFE)
+            safe_moves.push_back(index);
+        else
+            mine_moves.push_back(index);
+
+        EnqueueNeighbors(index);
+    }
+
+    /**
+     * @brief Applies the single cell rules to one constraint and the pair rule against every
+     * constraint sharing a cell with it.
+     *
+     * @param index Flat index of the revealed number.
+     */
+    void Solver::Process(int index)
+    {
+        Constraint own;
+        if (!BuildConstraint(index, &own))
+            return;
+
+        if (own.mines == 0 || own.mines == own.count)
+        {
+            for (int i = 0; i < own.count; i++)
+                Deduce(own.cells[i], own.mines == 0 ? KNOWN_SAFE : KNOWN_MINE);
+            return;
+        }
+
+        // Pair rule: if B has exactly |B \ A| more mines than A, all of B \ A are mines and A \ B is safe
+        auto apply_pair = [this](const Constraint &a, const Constraint &b)
+        {
+            int a_only[8], b_only[8];
+            int a_only_count = 0, b_only_count = 0;
+
+            for (int i = 0; i < a.count; i++)
+            {
+                bool shared = false;
+                for (int j = 0; j < b.count && !shared; j++)
+                    shared = a.cells[i] == b.cells[j];
+                if (!shared)
+                    a_only[a_only_count++] = a.cells[i];
+            }
+            for (int j = 0; j < b.count; j++)
+            {
+                bool shared = false;
+                for (int i = 0; i < a.count && !shared; i++)
+                    shared = a.cells[i] == b.cells[j];
+                if (!shared)
+                    b_only[b_only_count++] = b.cells[j];
+            }
+
+            if (a_only_count + b_only_count == 0 || b.mines - a.mines != b_only_count)
+                return false;
+
+            for (int i = 0; i < a_only_count; i++)
+                Deduce(a_only[i], KNOWN_SAFE);
+            for (int j = 0; j < b_only_count; j++)
+                Deduce(b_only[j], KNOWN_MINE);
+            return true;
+        };
+
+        int row = index / columns;
+        int col = index % columns;
+
+        for (int d_row = -2; d_row <= 2; d_row++)
+        {
+            for (int d_col = -2; d_col <= 2; d_col++)
+            {
+                if ((d_row == 0 && d_col == 0) || !board.IsValid(row + d_row, col + d_col))
+                    continue;
+
+                int other_index = index + d_row * columns + d_col;
+                Constraint other;
+                if (!IsConstraint(other_index) || !BuildConstraint(other_index, &other))
+                    continue;
+
+                if (apply_pair(own, other) || apply_pair(other, own))
+                {
+                    // The own constraint changed, look at it again with the new knowledge
+                    Enqueue(index);
+                    return;
+                }
+            }
+        }
+    }
+
+    void Solver::Propagate()
+    {
+        while (!work.empty())
+        {
+            int index = work.front();
+            work.pop_front();
+            queued[index] = 0;
+            Process(index);
+        }
+    }
+}
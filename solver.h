@@ -0,0 +1,123 @@
+#ifndef SOLVER_H
+#define SOLVER_H
+
+#include <vector>
+#include <deque>
+#include <cstdint>
+#include "board.h"
+
+namespace minis
+{
+    /**
+     * @brief A move the solver is certain about.
+     *
+     */
+    struct SolverMove
+    {
+        int row;
+        int col;
+        bool mine;
+    };
+
+    /**
+     * @brief Deterministic minesweeper solver. Every revealed number is a constraint "the concealed
+     * neighbors hold n mines". Single constraints are resolved directly (no mines left / all left
+     * cells are mines), overlapping pairs with the subset/difference rule.
+     * The solver is incremental: after a reveal only the constraints around the opened cells (and
+     * around cells deduced from them) are examined again.
+     * It relies on its own deductions and ignores the player's flags, which may be wrong.
+     *
+     */
+    class Solver
+    {
+    public:
+        /**
+         * @brief Construct a new Solver object for a board. Already revealed cells are picked up.
+         *
+         * @param board Board to solve, has to outlive the solver.
+         */
+        explicit Solver(const Board &board);
+
+        /**
+         * @brief Forgets all deductions and picks up the revealed cells again, i. e. after
+         * `Board::Reset`. The storage is reused.
+         *
+         */
+        void Reset();
+
+        /**
+         * @brief Tells the solver about newly opened cells (i. e. `Board::LastOpened()`).
+         *
+         * @param opened Flat indices of the opened cells.
+         */
+        void Observe(const std::vector<int> &opened);
+
+        /**
+         * @brief Returns the next certain move which has not been played yet.
+         *
+         * @param move Receives the move.
+         * @return true A move was found.
+         * @return false Nothing is certain in the current position.
+         */
+        bool NextMove(SolverMove *move);
+
+        /**
+         * @brief Returns the next cell which is certainly safe and still concealed.
+         *
+         * @param move Receives the move.
+         * @return true A safe cell was found.
+         * @return false No safe cell is certain in the current position.
+         */
+        bool NextSafe(SolverMove *move);
+
+        /**
+         * @brief Checks if the solver deduced a cell to be a mine.
+         *
+         */
+        inline bool KnownMine(int index) const { return knowledge[index] == KNOWN_MINE; }
+
+        /**
+         * @brief Checks if the solver deduced a cell to be safe.
+         *
+         */
+        inline bool KnownSafe(int index) const { return knowledge[index] == KNOWN_SAFE; }
+
+    private:
+        enum Knowledge : uint8_t
+        {
+            UNKNOWN = 0,
+            KNOWN_SAFE,
+            KNOWN_MINE,
+        };
+
+        /**
+         * @brief Constraint of a revealed number: `mines` mines among `count` unknown `cells`.
+         *
+         */
+        struct Constraint
+        {
+            int cells[8];
+            int count = 0;
+            int mines = 0;
+        };
+
+        const Board &board;
+        int rows;
+        int columns;
+        std::vector<uint8_t> knowledge;
+        std::vector<uint8_t> queued;
+        std::deque<int> work;
+        std::vector<int> safe_moves;
+        std::vector<int> mine_moves;
+
+        bool IsConstraint(int index) const;
+        bool BuildConstraint(int index, Constraint *constraint) const;
+        void Enqueue(int index);
+        void EnqueueNeighbors(int index);
+        void Deduce(int index, Knowledge value);
+        void Process(int index);
+        void Propagate();
+    };
+}
+
+#endif
@@ -0,0 +1,168 @@
+#include <cstdio>
+#include <vector>
+#include "board.h"
+#include "mine_placement.h"
+#include "no_guess.h"
+#include "rng.h"
+#include "solver.h"
+
+using namespace ::minis;
+
+#define SOLVER_TEST_GAMES 300
+#define NO_GUESS_TEST_BOARDS 20
+
+static int failed = 0;
+
+static void Check(bool condition, const char *what)
+{
+    if (condition)
+        return;
+    printf("FAILED: %s\n", what);
+    failed++;
+}
+
+/**
+ * @brief Returns true if every deduction of the solver agrees with the real layout.
+ *
+ */
+static bool DeductionsHold(const Board &board, const Solver &solver)
+{
+    for (int i = 0; i < board.Rows() * board.Columns(); i++)
+    {
+        bool mine = board.At(i / board.Columns(), i % board.Columns()).mine;
+        if ((solver.KnownMine(i) && !mine) || (solver.KnownSafe(i) && mine))
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Plays the moves of the solver to the end of the game and checks its deductions against
+ * the mines after every move. Where the solver is stuck a free cell is opened for it, so the
+ * games go on to positions a real guess would rarely reach. Some flags are set on wrong cells,
+ * which the solver has to ignore.
+ *
+ */
+static void TestDeductions(Rng &rng, int rows, int columns, int mines)
+{
+    int row = (int)rng.Below(rows), col = (int)rng.Below(columns);
+    Board board(rows, columns, mines, rng.Next(), SafeZone(rows, columns, row, col));
+    board.Reveal(row, col);
+    Solver solver(board);
+
+    bool sound = true, safe_moves = true;
+    int deduced = 0;
+    SolverMove move;
+    while (!board.Won() && !board.Lost() && sound)
+    {
+        if (solver.NextMove(&move))
+        {
+            deduced++;
+            if (move.mine)
+            {
+                if (!board.At(move.row, move.col).flagged)
+                    board.ToggleFlag(move.row, move.col);
+                continue;
+            }
+            safe_moves = safe_moves && !board.At(move.row, move.col).mine;
+            if (board.At(move.row, move.col).flagged)
+                board.ToggleFlag(move.row, move.col);
+        }
+        else
+        {
+            // Stuck: open a random free cell, sometimes flag a free one as well
+            std::vector<int> free;
+            for (int i = 0; i < rows * columns; i++)
+            {
+                const Cell &cell = board.At(i / columns, i % columns);
+                if (cell.concealed && !cell.mine && !cell.flagged)
+                    free.push_back(i);
+            }
+            if (free.empty())
+                break;
+            int index = free[rng.Below(free.size())];
+            if (free.size() > 1 && rng.Below(8) == 0)
+                board.ToggleFlag(index / columns, index % columns);
+            index = free[rng.Below(free.size())];
+            if (board.At(index / columns, index % columns).flagged)
+                continue;
+            move = {index / columns, index % columns, false};
+        }
+
+        board.Reveal(move.row, move.col);
+        solver.Observe(board.LastOpened());
+        sound = DeductionsHold(board, solver);
+    }
+
+    Check(sound, "no deduced safe cell holds a mine and every deduced mine is one");
+    Check(safe_moves && !board.Lost(), "the solver never opens a mine");
+    Check(deduced > 0 || board.Won(), "the solver deduces something");
+
+    // Picking up the same position from scratch gives sound deductions as well
+    if (!board.Lost())
+    {
+        solver.Reset();
+        Check(DeductionsHold(board, solver), "the deductions after Reset hold");
+    }
+}
+
+/**
+ * @brief Generates a no-guess board and clears it with a fresh solver from the opening alone,
+ * playing both its safe cells and its mines.
+ *
+ */
+static void TestNoGuess(uint64_t seed, int rows, int columns, int mines)
+{
+    Board board;
+    if (!GenerateNoGuess(rows, columns, mines, seed, &board))
+    {
+        Check(false, "a no-guess board is found");
+        return;
+    }
+    Check(board.OpenCount() > 0 && !board.Lost() && !board.Won(), "the no-guess board comes with its opening");
+
+    Solver solver(board);
+    SolverMove move;
+    bool flags_on_mines = true;
+    while (!board.Won() && !board.Lost() && solver.NextMove(&move))
+    {
+        if (move.mine)
+        {
+            flags_on_mines = flags_on_mines && board.At(move.row, move.col).mine;
+            board.ToggleFlag(move.row, move.col);
+            continue;
+        }
+        board.Reveal(move.row, move.col);
+        solver.Observe(board.LastOpened());
+    }
+    Check(board.Won(), "the solver clears a no-guess board from the first click");
+    Check(flags_on_mines, "the solver flags only mines on a no-guess board");
+}
+
+/**
+ * @brief Checks the deductions of `Solver` against the real layout of many random games on the
+ * standard board sizes, and that it clears every board of `GenerateNoGuess`.
+ *
+ */
+int main()
+{
+    Rng rng(7);
+    for (int game = 0; game < SOLVER_TEST_GAMES; game++)
+    {
+        TestDeductions(rng, 9, 9, 10);
+        TestDeductions(rng, 16, 16, 40);
+        TestDeductions(rng, 16, 30, 99);
+    }
+    for (int seed = 1; seed <= NO_GUESS_TEST_BOARDS; seed++)
+    {
+        TestNoGuess(seed, 9, 9, 10);
+        TestNoGuess(seed, 16, 16, 40);
+        TestNoGuess(seed, 16, 30, 99);
+    }
+
+    Board board(9, 9, 10, 1);
+    Check(!GenerateNoGuess(9, 9, 10, 1, &board, 0) && board.OpenCount() == 0, "a failed generation leaves the board alone");
+
+    printf("%d checks failed\n", failed);
+    return failed > 0 ? 1 : 0;
+}
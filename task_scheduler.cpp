@@ -0,0 +1,119 @@
+#include "task_scheduler.h"
+#include <algorithm>
+
+namespace minis
+{
+    namespace
+    {
+        // Lets `Submit` find the deque of the worker calling it
+        thread_local const TaskScheduler *current_scheduler = nullptr;
+        thread_local int current_worker = -1;
+    }
+
+    TaskScheduler::TaskScheduler(int threads)
+    {
+        threads = std::max(1, threads);
+        for (int i = 0; i < threads; i++)
+            workers.push_back(std::unique_ptr<Worker>(new Worker()));
+        for (int i = 0; i < threads; i++)
+            this->threads.emplace_back(&TaskScheduler::Work, this, i);
+    }
+
+    TaskScheduler::~TaskScheduler()
+    {
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+
+        for (std::thread &thread : threads)
+            thread.join();
+    }
+
+    void TaskScheduler::Submit(std::function<void()> task)
+    {
+        int index = current_scheduler == this ? current_worker : (int)(next_worker++ % workers.size());
+
+        // Counted first, so a worker seeing no queued tasks never misses this one
+        queued++;
+        {
+            std::lock_guard<std::mutex> lock(workers[index]->mutex);
+            workers[index]->tasks.push_back(std::move(task));
+        }
+
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+        if (sleeping > 0)
+            wake.notify_one();
+    }
+
+    /**
+     * @brief Takes the oldest task of the worker's own deque or else steals the newest one of
+     * another worker.
+     *
+     */
+    bool TaskScheduler::Take(int index, std::function<void()> *task)
+    {
+        {
+            Worker &own = *workers[index];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.tasks.empty())
+            {
+                *task = std::move(own.tasks.front());
+                own.tasks.pop_front();
+                queued--;
+                return true;
+            }
+        }
+
+        for (size_t i = 1; i < workers.size(); i++)
+        {
+            Worker &victim = *workers[(index + i) % workers.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty())
+            {
+                *task = std::move(victim.tasks.back());
+                victim.tasks.pop_back();
+                queued--;
+                steals++;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void TaskScheduler::Work(int index)
+    {
+        current_scheduler = this;
+        current_worker = index;
+        std::function<void()> task;
+
+        while (true)
+        {
+            // Spin a little before sleeping, waking a sleeping thread costs more than a move
+            bool found = false;
+            for (int spin = 0; spin < TASK_SCHEDULER_SPIN && !found; spin++)
+            {
+                found = queued > 0 && Take(index, &task);
+                if (!found)
+                    std::this_thread::yield();
+            }
+
+            if (found)
+            {
+                task();
+                task = nullptr;
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(sleep_mutex);
+            sleeping++;
+            wake.wait(lock, [this]
+                      { return queued > 0 || stopping; });
+            sleeping--;
+            if (stopping && queued == 0)
+                return;
+        }
+    }
+}
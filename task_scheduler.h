@@ -0,0 +1,80 @@
+#ifndef TASK_SCHEDULER_H
+#define TASK_SCHEDULER_H
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <atomic>
+
+#define TASK_SCHEDULER_SPIN 2000
+
+namespace minis
+{
+    /**
+     * @brief Runs tasks on a fixed set of worker threads with work stealing: every worker has its
+     * own deque, tasks submitted by a worker go to its own deque (their data is hot in its cache),
+     * tasks from other threads are spread round robin. Workers take their own tasks oldest first,
+     * so requests are answered in the order they came in. A worker which runs dry steals the
+     * newest task of another worker before it goes to sleep.
+     *
+     */
+    class TaskScheduler
+    {
+    public:
+        /**
+         * @brief Construct a new TaskScheduler object and start the workers.
+         *
+         * @param threads Number of worker threads, at least one.
+         */
+        explicit TaskScheduler(int threads);
+
+        /**
+         * @brief Runs the tasks still queued, then stops and joins the workers.
+         *
+         */
+        ~TaskScheduler();
+
+        TaskScheduler(const TaskScheduler &) = delete;
+        TaskScheduler &operator=(const TaskScheduler &) = delete;
+
+        /**
+         * @brief Queues a task, it may run on any worker.
+         *
+         */
+        void Submit(std::function<void()> task);
+
+        inline int Threads() const { return (int)workers.size(); }
+
+        /**
+         * @brief Returns the number of tasks a worker took from another worker's deque.
+         *
+         */
+        inline long Steals() const { return steals; }
+
+    private:
+        struct Worker
+        {
+            std::mutex mutex;
+            std::deque<std::function<void()>> tasks;
+        };
+
+        std::vector<std::unique_ptr<Worker>> workers;
+        std::vector<std::thread> threads;
+        std::atomic<long> queued{0};
+        std::atomic<long> steals{0};
+        std::atomic<unsigned> next_worker{0};
+        std::mutex sleep_mutex;
+        std::condition_variable wake;
+        int sleeping = 0;
+        bool stopping = false;
+
+        bool Take(int index, std::function<void()> *task);
+        void Work(int index);
+    };
+}
+
+#endif
@@ -0,0 +1,261 @@
+#include "tournament.h"
+#include "mine_placement.h"
+#include "mine_probability.h"
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+namespace minis
+{
+    namespace
+    {
+        /**
+         * @brief Picks a random concealed cell which is not flagged and not `excluded`, by
+         * rejection while those are common and by counting them once they are rare.
+         *
+         */
+        template <typename Excluded>
+        bool RandomConcealed(const Board &board, Rng &rng, Excluded excluded, int *index)
+        {
+            int cells = board.Rows() * board.Columns();
+            auto candidate = [&](int i)
+            {
+                const Cell &cell = board.At(i / board.Columns(), i % board.Columns());
+                return cell.concealed && !cell.flagged && !excluded(i);
+            };
+
+            for (int attempt = 0; attempt < 32; attempt++)
+            {
+                int i = (int)rng.Below(cells);
+                if (candidate(i))
+                {
+                    *index = i;
+                    return true;
+                }
+            }
+
+            int count = 0;
+            for (int i = 0; i < cells; i++)
+                count += candidate(i);
+            if (count == 0)
+                return false;
+
+            int pick = (int)rng.Below(count);
+            for (int i = 0; i < cells; i++)
+            {
+                if (candidate(i) && pick-- == 0)
+                {
+                    *index = i;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /**
+         * @brief Reveals random cells, the baseline.
+         *
+         */
+        class RandomStrategy : public TournamentStrategy
+        {
+        public:
+            explicit RandomStrategy(const Board &board) : board(board) {}
+
+            bool NextMove(Rng &rng, SolverMove *move) override
+            {
+                int index;
+                if (!RandomConcealed(board, rng, [](int)
+                                     { return false; },
+                                     &index))
+                    return false;
+                *move = SolverMove{index / board.Columns(), index % board.Columns(), false};
+                return true;
+            }
+
+        private:
+            const Board &board;
+        };
+
+        /**
+         * @brief Plays every move the solver is certain about (flags included) and guesses a
+         * random cell which is not a known mine when it is stuck.
+         *
+         */
+        class SolverStrategy : public TournamentStrategy
+        {
+        public:
+            explicit SolverStrategy(const Board &board) : board(board), solver(board) {}
+
+            void NewGame() override { solver.Reset(); }
+            void Observe(const std::vector<int> &opened) override { solver.Observe(opened); }
+
+            bool NextMove(Rng &rng, SolverMove *move) override
+            {
+                if (solver.NextMove(move))
+                    return true;
+                return Guess(rng, move);
+            }
+
+        protected:
+            const Board &board;
+            Solver solver;
+
+            virtual bool Guess(Rng &rng, SolverMove *move)
+            {
+                int index;
+                if (!RandomConcealed(board, rng, [this](int i)
+                                     { return solver.KnownMine(i); },
+                                     &index))
+                    return false;
+                *move = SolverMove{index / board.Columns(), index % board.Columns(), false};
+                return true;
+            }
+        };
+
+        /**
+         * @brief Like the solver strategy, but guesses the cell least likely to be a mine.
+         *
+         */
+        class ProbabilityStrategy : public SolverStrategy
+        {
+        public:
+            explicit ProbabilityStrategy(const Board &board) : SolverStrategy(board), probability(board) {}
+
+        protected:
+            bool Guess(Rng & /*rng*/, SolverMove *move) override
+            {
+                probability.Update();
+                int index = probability.SafestCell();
+                if (index < 0)
+                    return false;
+                *move = SolverMove{index / board.Columns(), index % board.Columns(), false};
+                return true;
+            }
+
+        private:
+            MineProbability probability;
+        };
+
+        /**
+         * @brief Totals of one thread, padded so the threads never write to the same cache line.
+         *
+         */
+        struct alignas(64) ThreadTotals
+        {
+            long games = 0;
+            long won = 0;
+            long long moves = 0;
+            long wrong_flags = 0;
+            double seconds = 0.0;
+        };
+
+        void PlayGames(const TournamentConfig &config, int thread, ThreadTotals *totals)
+        {
+            auto start = std::chrono::steady_clock::now();
+            GameSettings settings = GetSettings(config.level);
+            Board board(settings.rows, settings.columns, settings.mines, 0);
+            std::unique_ptr<TournamentStrategy> strategy = MakeStrategy(config.strategy, board);
+            // Every move reveals or flags a cell, so a game which takes longer is stuck
+            long long max_moves = 2LL * settings.rows * settings.columns;
+
+            for (long game = thread; game < config.games; game += config.threads)
+            {
+                Rng rng(config.seed ^ (0x9E3779B97F4A7C15ULL * (uint64_t)(game + 1)));
+                int row, col;
+                strategy->FirstMove(rng, settings.rows, settings.columns, &row, &col);
+                board.Reset(rng.Next(), SafeZone(settings.rows, settings.columns, row, col));
+                strategy->NewGame();
+
+                board.Reveal(row, col);
+                strategy->Observe(board.LastOpened());
+                long long moves = 1;
+
+                SolverMove move;
+                while (!board.Lost() && !board.Won() && moves < max_moves && strategy->NextMove(rng, &move))
+                {
+                    if (move.mine)
+                    {
+                        board.ToggleFlag(move.row, move.col);
+                    }
+                    else
+                    {
+                        board.Reveal(move.row, move.col);
+                        strategy->Observe(board.LastOpened());
+                    }
+                    moves++;
+                }
+
+                totals->games++;
+                totals->won += board.Won();
+                totals->moves += moves;
+                totals->wrong_flags += board.FlagCount() - board.Bits().CountFlagsOnMines();
+            }
+
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            totals->seconds = elapsed.count();
+        }
+    }
+
+    void TournamentStrategy::FirstMove(Rng &rng, int rows, int columns, int *row, int *col)
+    {
+        *row = (int)rng.Below(rows);
+        *col = (int)rng.Below(columns);
+    }
+
+    std::unique_ptr<TournamentStrategy> MakeStrategy(const std::string &name, const Board &board)
+    {
+        if (name == "random")
+            return std::unique_ptr<TournamentStrategy>(new RandomStrategy(board));
+        if (name == "solver")
+            return std::unique_ptr<TournamentStrategy>(new SolverStrategy(board));
+        if (name == "probability")
+            return std::unique_ptr<TournamentStrategy>(new ProbabilityStrategy(board));
+        return nullptr;
+    }
+
+    bool RunTournament(const TournamentConfig &config, TournamentResult *result)
+    {
+        Board probe(1, 1, 0, 0);
+        if (!MakeStrategy(config.strategy, probe) || config.threads < 1)
+            return false;
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<ThreadTotals> totals(config.threads);
+        std::vector<std::thread> threads;
+        for (int thread = 0; thread < config.threads; thread++)
+            threads.emplace_back(PlayGames, std::cref(config), thread, &totals[thread]);
+        for (std::thread &thread : threads)
+            thread.join();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        *result = TournamentResult();
+        result->seconds = elapsed.count();
+        for (const ThreadTotals &thread : totals)
+        {
+            result->games += thread.games;
+            result->won += thread.won;
+            result->moves += thread.moves;
+            result->wrong_flags += thread.wrong_flags;
+            result->thread_seconds += thread.seconds;
+        }
+        return true;
+    }
+
+    void WinRateInterval(long won, long games, double z, double *low, double *high)
+    {
+        if (games <= 0)
+        {
+            *low = 0.0;
+            *high = 1.0;
+            return;
+        }
+
+        double n = (double)games;
+        double p = won / n;
+        double denominator = 1.0 + z * z / n;
+        double center = (p + z * z / (2.0 * n)) / denominator;
+        double margin = z * std::sqrt(p * (1.0 - p) / n + z * z / (4.0 * n * n)) / denominator;
+        *low = std::max(0.0, center - margin);
+        *high = std::min(1.0, center + margin);
+    }
+}
@@ -0,0 +1,113 @@
+#ifndef TOURNAMENT_H
+#define TOURNAMENT_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <cstdint>
+#include "rng.h"
+#include "board.h"
+#include "solver.h"
+#include "settings.h"
+
+namespace minis
+{
+    /**
+     * @brief A bot for `RunTournament`. Every worker thread has its own strategy object, created
+     * by `MakeStrategy` for the thread's board, which is reused from game to game.
+     *
+     */
+    class TournamentStrategy
+    {
+    public:
+        virtual ~TournamentStrategy() = default;
+
+        /**
+         * @brief Picks the first click before the mines are placed, its neighbors stay free of
+         * mines like in the game. Defaults to a random cell.
+         *
+         */
+        virtual void FirstMove(Rng &rng, int rows, int columns, int *row, int *col);
+
+        /**
+         * @brief Called after the board was reset, before the first click.
+         *
+         */
+        virtual void NewGame() {}
+
+        /**
+         * @brief Called with the cells every reveal opened (`Board::LastOpened`).
+         *
+         */
+        virtual void Observe(const std::vector<int> & /*opened*/) {}
+
+        /**
+         * @brief Picks the next move.
+         *
+         * @param rng Random numbers of the game, the same game plays the same on any thread.
+         * @param move Receives the move, a mine is flagged and any other cell revealed.
+         * @return true A move was picked.
+         * @return false The bot gives up, the game counts as lost.
+         */
+        virtual bool NextMove(Rng &rng, SolverMove *move) = 0;
+    };
+
+    // Strategies known to `MakeStrategy`, see tournament.cpp
+    const char *const tournament_strategy_names[] = {"random", "solver", "probability"};
+
+    /**
+     * @brief Creates a strategy by name.
+     *
+     * @param name One of `tournament_strategy_names`.
+     * @param board Board the strategy plays on, has to outlive it.
+     * @return std::unique_ptr<TournamentStrategy> The strategy, empty for an unknown name.
+     */
+    std::unique_ptr<TournamentStrategy> MakeStrategy(const std::string &name, const Board &board);
+
+    struct TournamentConfig
+    {
+        DifficultyLevel level;
+        std::string strategy;
+        long games;
+        int threads;
+        uint64_t seed;
+    };
+
+    struct TournamentResult
+    {
+        long games = 0;
+        long won = 0;
+        long long moves = 0;
+        // Flags on cells without a mine, the strategies only flag deduced mines, so it has to stay 0
+        long wrong_flags = 0;
+        // Wall clock time and the time summed over the threads
+        double seconds = 0.0;
+        double thread_seconds = 0.0;
+    };
+
+    /**
+     * @brief Plays `config.games` games on `config.threads` threads. Game `i` is seeded from
+     * `config.seed` and `i` only, so the results do not depend on the number of threads. Each
+     * thread plays on its own board, strategy and random numbers, the threads only meet when
+     * their results are summed up.
+     *
+     * @param config Level, strategy, number of games and threads and the seed.
+     * @param result Receives the totals.
+     * @return true The tournament was played.
+     * @return false The strategy is unknown.
+     */
+    bool RunTournament(const TournamentConfig &config, TournamentResult *result);
+
+    /**
+     * @brief Wilson score interval of a win rate.
+     *
+     * @param won Games won.
+     * @param games Games played.
+     * @param z Quantile of the normal distribution, 1.96 for 95 %.
+     * @param low Receives the lower bound.
+     * @param high Receives the upper bound.
+     */
+    void WinRateInterval(long won, long games, double z, double *low, double *high);
+}
+
+#endif
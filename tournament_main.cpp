@@ -0,0 +1,153 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include "tournament.h"
+
+using namespace ::minis;
+
+#define TOURNAMENT_DEFAULT_GAMES 100000
+#define TOURNAMENT_Z_95 1.96
+
+static void PrintUsage(const char *program)
+{
+    fprintf(stderr, "Usage: %s [--games <n>] [--level <0-%d> | all] [--strategy <", program, DIFFICULTY_LEVEL_COUNT - 1);
+    for (size_t i = 0; i < sizeof(tournament_strategy_names) / sizeof(*tournament_strategy_names); i++)
+        fprintf(stderr, "%s%s", i > 0 ? " | " : "", tournament_strategy_names[i]);
+    fprintf(stderr, ">] [--threads <n>] [--seed <n>] [--scaling] [--csv]\n");
+}
+
+static void PrintResult(const TournamentConfig &config, const TournamentResult &result, bool csv)
+{
+    GameSettings settings = GetSettings(config.level);
+    double low, high;
+    WinRateInterval(result.won, result.games, TOURNAMENT_Z_95, &low, &high);
+    double rate = result.games > 0 ? (double)result.won / result.games : 0.0;
+    double games_per_second = result.seconds > 0.0 ? result.games / result.seconds : 0.0;
+    // Per move on one thread, the wall clock time would shrink with the number of threads
+    double move_us = result.moves > 0 ? result.thread_seconds * 1e6 / result.moves : 0.0;
+
+    if (csv)
+    {
+        printf("%d,%d,%d,%s,%d,%ld,%ld,%.6f,%.6f,%.6f,%.1f,%.4f\n", settings.rows, settings.columns, settings.mines,
+               config.strategy.c_str(), config.threads, result.games, result.won, rate, low, high, games_per_second, move_us);
+        return;
+    }
+
+    char board[32];
+    snprintf(board, sizeof(board), "%d x %d, %d", settings.rows, settings.columns, settings.mines);
+    printf("%-16s %-12s %8d %10ld %7.2f %% [%6.2f, %6.2f] %12.0f %10.3f\n", board, config.strategy.c_str(), config.threads,
+           result.games, rate * 100.0, low * 100.0, high * 100.0, games_per_second, move_us);
+}
+
+/**
+ * @brief Plays the same tournament on 1, 2, 4, ... threads and prints the speedup over one thread.
+ *
+ */
+static void PrintScaling(TournamentConfig config, int max_threads, bool csv)
+{
+    if (csv)
+        printf("threads,games_per_second,speedup,efficiency\n");
+    else
+        printf("\n%8s %12s %8s %10s\n", "Threads", "Games/s", "Speedup", "Efficiency");
+
+    double single = 0.0;
+    for (int threads = 1;; threads = std::min(threads * 2, max_threads))
+    {
+        config.threads = threads;
+        TournamentResult result;
+        RunTournament(config, &result);
+        double games_per_second = result.games / result.seconds;
+        if (threads == 1)
+            single = games_per_second;
+
+        double speedup = games_per_second / single;
+        if (csv)
+            printf("%d,%.1f,%.3f,%.3f\n", threads, games_per_second, speedup, speedup / threads);
+        else
+            printf("%8d %12.0f %7.2fx %9.1f %%\n", threads, games_per_second, speedup, speedup / threads * 100.0);
+
+        if (threads == max_threads)
+            break;
+    }
+}
+
+/**
+ * @brief Plays many games with a bot and reports its win rate (with a 95 % confidence interval)
+ * and the throughput, to tune the generator and check solver changes.
+ * minisweeper_tournament [--games <n>] [--level <0-6> | all] [--strategy <name>] [--threads <n>] [--seed <n>] [--scaling] [--csv]
+ *
+ */
+int main(int argc, char **argv)
+{
+    TournamentConfig config = TournamentConfig{EXPERT_1, "solver", TOURNAMENT_DEFAULT_GAMES, (int)std::max(1u, std::thread::hardware_concurrency()), 1};
+    bool all_levels = false;
+    bool scaling = false;
+    bool csv = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--games") == 0 && i + 1 < argc)
+            config.games = atol(argv[++i]);
+        else if (strcmp(argv[i], "--level") == 0 && i + 1 < argc)
+        {
+            const char *level = argv[++i];
+            all_levels = strcmp(level, "all") == 0;
+            config.level = (DifficultyLevel)atoi(level);
+        }
+        else if (strcmp(argv[i], "--strategy") == 0 && i + 1 < argc)
+            config.strategy = argv[++i];
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            config.threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+            config.seed = strtoull(argv[++i], nullptr, 10);
+        else if (strcmp(argv[i], "--scaling") == 0)
+            scaling = true;
+        else if (strcmp(argv[i], "--csv") == 0)
+            csv = true;
+        else
+        {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    Board probe(1, 1, 0, 0);
+    if (config.games < 1 || config.threads < 1 || config.level < 0 || config.level >= DIFFICULTY_LEVEL_COUNT ||
+        !MakeStrategy(config.strategy, probe))
+    {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    if (csv)
+        printf("rows,columns,mines,strategy,threads,games,won,win_rate,win_rate_low,win_rate_high,games_per_second,move_us\n");
+    else
+        printf("%-16s %-12s %8s %10s %9s %16s %12s %10s\n", "Board", "Strategy", "Threads", "Games", "Win rate", "95 % interval", "Games/s", "us/move");
+
+    int first = all_levels ? 0 : config.level;
+    int last = all_levels ? DIFFICULTY_LEVEL_COUNT - 1 : config.level;
+    long wrong_flags = 0;
+    for (int level = first; level <= last; level++)
+    {
+        config.level = (DifficultyLevel)level;
+        TournamentResult result;
+        RunTournament(config, &result);
+        PrintResult(config, result, csv);
+        wrong_flags += result.wrong_flags;
+    }
+
+    if (scaling)
+        PrintScaling(config, config.threads, csv);
+
+    // A flag without a mine means the solver deduced a mine wrongly
+    if (wrong_flags > 0)
+    {
+        fprintf(stderr, "%ld flags on cells without a mine\n", wrong_flags);
+        return 1;
+    }
+    return 0;
+}